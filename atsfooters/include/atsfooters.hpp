@@ -4,6 +4,9 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <stdexcept>
 #include <vector>
 
 #ifndef ATSFOOTERSLIB
@@ -146,8 +149,53 @@ struct ats_footer_configuration {
     bool fifo;
 };
 
+/// How footers are stored in DMA buffers. The enumerators are an
+/// implementation detail of the library.
+enum class ats_footer_embedding : int;
+
+/// Location of the record footers of an acquisition in its DMA buffers,
+/// computed once from an `ats_footer_configuration`. Offsets are relative to
+/// the start of the first buffer, and buffers are assumed to be contiguous in
+/// memory.
+struct ats_footer_layout {
+    ats_footer_embedding embedding;
+    size_t bytes_per_sample;
+    size_t active_channel_count;
+    size_t records_per_buffer;
+    size_t record_size_bytes;
+    size_t samples_per_record;
+    size_t footer_block_size_bytes;
+    size_t sample_stride_bytes;
+    size_t channel_stride_bytes;
+    size_t record_stride_bytes;
+
+    /// Size of one DMA buffer, in bytes
+    size_t buffer_stride_bytes;
+};
+
 ats_footer_type ATSFOOTERSLIB get_ats_footer_type(ats_board_type board_type);
 
+/// Computes the footer layout of a configuration. Throws if the configuration
+/// is invalid.
+ats_footer_layout ATSFOOTERSLIB
+ats_get_footer_layout(ats_footer_configuration configuration);
+
+/// Decodes footer number `index` of `data`. The footer must lie within `data`.
+void ATSFOOTERSLIB ats_read_footer(span<char> data,
+                                   const ats_footer_layout &layout,
+                                   size_t index, ats_footer_type_0 *footer);
+
+void ATSFOOTERSLIB ats_read_footer(span<char> data,
+                                   const ats_footer_layout &layout,
+                                   size_t index, ats_footer_type_1 *footer);
+
+/// Decodes the first `footers.size()` footers of `data`. Throws if any footer
+/// does not have the type of the board.
+///
+/// Footers are gathered in thread-local scratch memory that is kept between
+/// calls, so that parsing does not allocate once warmed up. Each thread keeps
+/// `ats_footer_scratch_size()` bytes for the largest footer count it parsed,
+/// until it exits. Use the overloads below to control this memory.
 void ATSFOOTERSLIB ats_parse_footers(span<char> data,
                                      ats_footer_configuration configuration,
                                      span<ats_footer_type_0> footers);
@@ -156,6 +204,223 @@ void ATSFOOTERSLIB ats_parse_footers(span<char> data,
                                      ats_footer_configuration configuration,
                                      span<ats_footer_type_1> footers);
 
+/// Number of bytes of scratch memory that `ats_parse_footers()` needs to
+/// parse `footer_count` footers, whatever the acquisition configuration
+size_t ATSFOOTERSLIB ats_footer_scratch_size(size_t footer_count);
+
+/// Variant of `ats_parse_footers()` for threads that must not allocate
+/// memory. All temporary storage comes from `scratch`, which must hold at
+/// least `ats_footer_scratch_size()` bytes, and errors are reported without
+/// exceptions: on failure, returns -1 and writes a NUL-terminated message to
+/// `error_message`. Returns 0 on success. `footers` is only written once all
+/// footers are known to be valid.
+int ATSFOOTERSLIB ats_parse_footers(span<char> data,
+                                    ats_footer_configuration configuration,
+                                    span<ats_footer_type_0> footers,
+                                    span<char> scratch,
+                                    span<char> error_message) noexcept;
+
+int ATSFOOTERSLIB ats_parse_footers(span<char> data,
+                                    ats_footer_configuration configuration,
+                                    span<ats_footer_type_1> footers,
+                                    span<char> scratch,
+                                    span<char> error_message) noexcept;
+
+/// Same as above, with scratch memory allocated from `resource` for the
+/// duration of the call, e.g. a `std::pmr::monotonic_buffer_resource` or a
+/// pool owned by the caller
+int ATSFOOTERSLIB ats_parse_footers(span<char> data,
+                                    ats_footer_configuration configuration,
+                                    span<ats_footer_type_0> footers,
+                                    std::pmr::memory_resource *resource,
+                                    span<char> error_message) noexcept;
+
+int ATSFOOTERSLIB ats_parse_footers(span<char> data,
+                                    ats_footer_configuration configuration,
+                                    span<ats_footer_type_1> footers,
+                                    std::pmr::memory_resource *resource,
+                                    span<char> error_message) noexcept;
+
+/// Random-access range over the footers of DMA buffers, which decodes a footer
+/// from the raw bytes each time it is accessed. Creating a view neither
+/// allocates memory nor parses footers, which makes it cheap to look up a few
+/// footers, or to run standard algorithms such as `std::lower_bound` on
+/// timestamps.
+///
+/// Like those of `std::vector<bool>`, iterators are random-access iterators
+/// whose `reference` is not a real reference: dereferencing one returns the
+/// decoded footer by value.
+///
+/// `T` is `ats_footer_type_0` or `ats_footer_type_1`. Accessing a footer
+/// throws if its type does not match `T`. The view does not own `data`.
+template <class T> class ats_footer_view {
+    span<char> m_data;          //< DMA buffers holding the footers
+    ats_footer_layout m_layout; //< Location of footers in `m_data`
+    size_t m_size;              //< Number of footers in the view
+
+  public:
+    /// Random-access iterator returning footers by value
+    class iterator {
+        const ats_footer_view *m_view;
+        size_t m_index;
+
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = T;
+
+        iterator() noexcept : m_view(nullptr), m_index(0) {}
+        iterator(const ats_footer_view *view, size_t index) noexcept
+            : m_view(view), m_index(index) {}
+
+        T operator*() const { return (*m_view)[m_index]; }
+        T operator[](difference_type n) const {
+            return (*m_view)[m_index + n];
+        }
+
+        iterator &operator++() noexcept {
+            m_index++;
+            return *this;
+        }
+        iterator operator++(int) noexcept {
+            iterator it = *this;
+            m_index++;
+            return it;
+        }
+        iterator &operator--() noexcept {
+            m_index--;
+            return *this;
+        }
+        iterator operator--(int) noexcept {
+            iterator it = *this;
+            m_index--;
+            return it;
+        }
+        iterator &operator+=(difference_type n) noexcept {
+            m_index += n;
+            return *this;
+        }
+        iterator &operator-=(difference_type n) noexcept {
+            m_index -= n;
+            return *this;
+        }
+        iterator operator+(difference_type n) const noexcept {
+            return iterator(m_view, m_index + n);
+        }
+        friend iterator operator+(difference_type n, iterator it) noexcept {
+            return it + n;
+        }
+        iterator operator-(difference_type n) const noexcept {
+            return iterator(m_view, m_index - n);
+        }
+        difference_type operator-(iterator other) const noexcept {
+            return static_cast<difference_type>(m_index)
+                   - static_cast<difference_type>(other.m_index);
+        }
+
+        bool operator==(iterator other) const noexcept {
+            return m_index == other.m_index;
+        }
+        bool operator!=(iterator other) const noexcept {
+            return m_index != other.m_index;
+        }
+        bool operator<(iterator other) const noexcept {
+            return m_index < other.m_index;
+        }
+        bool operator>(iterator other) const noexcept {
+            return m_index > other.m_index;
+        }
+        bool operator<=(iterator other) const noexcept {
+            return m_index <= other.m_index;
+        }
+        bool operator>=(iterator other) const noexcept {
+            return m_index >= other.m_index;
+        }
+
+        /// Position of the footer in the view
+        size_t index() const noexcept { return m_index; }
+    };
+
+    /// View of the first `footer_count` footers of `data`. Throws if the
+    /// configuration is invalid, or if `data` is smaller than the buffers
+    /// that hold these footers.
+    ats_footer_view(span<char> data, ats_footer_configuration configuration,
+                    size_t footer_count)
+        : m_data(data), m_layout(ats_get_footer_layout(configuration)),
+          m_size(footer_count) {
+        const size_t buffer_count
+            = (footer_count + m_layout.records_per_buffer - 1)
+              / m_layout.records_per_buffer;
+        if (buffer_count * m_layout.buffer_stride_bytes > data.size())
+            throw std::runtime_error(
+                "Error: data buffer is too small for the footer count");
+        if (footer_count && !data.data())
+            throw std::runtime_error("Error: NULL data buffer");
+    }
+
+    /// View of the footers of all the complete DMA buffers in `data`
+    ats_footer_view(span<char> data, ats_footer_configuration configuration)
+        : m_data(data), m_layout(ats_get_footer_layout(configuration)),
+          m_size(data.size() / m_layout.buffer_stride_bytes
+                 * m_layout.records_per_buffer) {}
+
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    iterator begin() const noexcept { return iterator(this, 0); }
+    iterator end() const noexcept { return iterator(this, m_size); }
+
+    /// Decodes footer number `i`. `i` must be lower than `size()`.
+    T operator[](size_t i) const {
+        assert(i < m_size);
+        T footer;
+        ats_read_footer(m_data, m_layout, i, &footer);
+        return footer;
+    }
+
+    /// Same as `operator[]`, but throws if `i` is out of range
+    T at(size_t i) const {
+        if (i >= m_size)
+            throw std::out_of_range("Error: footer index out of range");
+        return (*this)[i];
+    }
+};
+
+/// Reduction applied to each group of records when decimating analog values
+enum class ats_analog_reduction {
+    min,
+    max,
+    mean,
+};
+
+/// Extracts the analog values of `footer_count` type 1 footers directly from
+/// `data`, without building `ats_footer_type_1` structures.
+///
+/// Consecutive groups of `decimation_factor` records are reduced to a single
+/// value using `reduction`. The last group may hold fewer records. `values`
+/// must have room for at least `ceil(footer_count / decimation_factor)`
+/// elements.
+///
+/// Returns the number of values written to `values`.
+size_t ATSFOOTERSLIB ats_parse_analog_values(
+    span<char> data, ats_footer_configuration configuration,
+    size_t footer_count, span<int16_t> values, size_t decimation_factor = 1,
+    ats_analog_reduction reduction = ats_analog_reduction::mean);
+
+/// Same as the `int16_t` overload, but each output value is multiplied by
+/// `scale`. A scale of `1.f / 32768` maps analog values to [-1, 1).
+size_t ATSFOOTERSLIB ats_parse_analog_values(
+    span<char> data, ats_footer_configuration configuration,
+    size_t footer_count, span<float> values, float scale,
+    size_t decimation_factor = 1,
+    ats_analog_reduction reduction = ats_analog_reduction::mean);
+
+extern "C" int ATSFOOTERSLIB c_get_ats_footer_type(
+    ats_board_type board_type, ats_footer_type *footer_type,
+    char *error_message, size_t error_message_max_size);
+
 extern "C" int ATSFOOTERSLIB c_ats_parse_footers_type_0(
     char *data, size_t data_size_bytes, ats_footer_configuration configuration,
     ats_footer_type_0 *footers, size_t footer_count, char *error_message,
@@ -166,4 +431,10 @@ extern "C" int ATSFOOTERSLIB c_ats_parse_footers_type_1(
     ats_footer_type_1 *footers, size_t footer_count, char *error_message,
     size_t error_message_max_size);
 
+extern "C" int ATSFOOTERSLIB c_ats_parse_analog_values(
+    char *data, size_t data_size_bytes, ats_footer_configuration configuration,
+    size_t footer_count, int16_t *values, size_t value_count,
+    size_t decimation_factor, ats_analog_reduction reduction,
+    char *error_message, size_t error_message_max_size);
+
 #endif // ATS_FOOTERS
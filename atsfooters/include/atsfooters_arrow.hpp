@@ -0,0 +1,55 @@
+#ifndef ATS_FOOTERS_ARROW
+#define ATS_FOOTERS_ARROW
+
+///
+/// @file
+///
+/// Export of footers as an Apache Arrow table, in the Arrow IPC stream or file
+/// format. Footers are decoded straight into the column buffers of the output,
+/// which tools such as pyarrow, Polars or DuckDB then read without copying,
+/// e.g. by memory-mapping a file written in the file format.
+///
+/// The table has one row per footer and the columns `trigger_timestamp`
+/// (uint64), `record_number` (uint32), `frame_count` (uint32), `aux_in_state`
+/// (bool) and, for type 1 footers, `analog_value` (int16). Footers whose type
+/// field does not match the board are null in every column.
+///
+
+#include <cstddef>
+#include <cstdint>
+
+#include "atsfooters.hpp"
+
+/// Arrow IPC formats
+enum class ats_arrow_format {
+    /// Streaming format, for pipes and sockets
+    stream,
+
+    /// Random access file format, with the `ARROW1` magic and a trailing
+    /// footer, suitable for memory-mapping
+    file,
+};
+
+/// Number of bytes that `ats_export_arrow_ipc()` writes for `footer_count`
+/// footers of type `footer_type`
+size_t ATSFOOTERSLIB ats_arrow_ipc_size(ats_footer_type footer_type,
+                                        size_t footer_count,
+                                        ats_arrow_format format);
+
+/// Parses `footer_count` footers from `data` and writes them to `output` as
+/// an Arrow table with a single record batch. Returns the number of bytes
+/// written, which is `ats_arrow_ipc_size()`. Throws if `output` is too small.
+size_t ATSFOOTERSLIB ats_export_arrow_ipc(
+    span<char> data, ats_footer_configuration configuration,
+    size_t footer_count, ats_arrow_format format, span<char> output);
+
+extern "C" size_t ATSFOOTERSLIB c_ats_arrow_ipc_size(
+    ats_footer_type footer_type, size_t footer_count, ats_arrow_format format);
+
+extern "C" int ATSFOOTERSLIB c_ats_export_arrow_ipc(
+    char *data, size_t data_size_bytes, ats_footer_configuration configuration,
+    size_t footer_count, ats_arrow_format format, char *output,
+    size_t output_size_bytes, char *error_message,
+    size_t error_message_max_size);
+
+#endif // ATS_FOOTERS_ARROW
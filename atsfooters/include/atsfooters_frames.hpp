@@ -0,0 +1,131 @@
+#ifndef ATS_FOOTERS_FRAMES
+#define ATS_FOOTERS_FRAMES
+
+///
+/// @file
+///
+/// Grouping of records into frames using the `frame_count` field of footers.
+/// The indexer consumes footers in acquisition order, one batch at a time, and
+/// emits one compact entry per frame without keeping per-record data.
+///
+
+#include <cstddef>
+#include <cstdint>
+
+#include "atsfooters.hpp"
+
+/// Flags describing anomalies of a frame. Flags combine with the bitwise
+/// operators below.
+enum class ats_frame_flags : uint32_t {
+    none = 0,
+
+    /// The frame holds fewer or more records than expected
+    incomplete = 0x1,
+
+    /// The frame count is not one more than the previous frame's, modulo
+    /// 2^24 since footers store it on 24 bits
+    out_of_order = 0x2,
+
+    /// Record numbers within the frame, or between the last record of the
+    /// previous frame and the first record of this one, are not consecutive
+    record_gap = 0x4,
+};
+
+constexpr ats_frame_flags operator|(ats_frame_flags a, ats_frame_flags b) {
+    return static_cast<ats_frame_flags>(static_cast<uint32_t>(a)
+                                        | static_cast<uint32_t>(b));
+}
+
+constexpr ats_frame_flags operator&(ats_frame_flags a, ats_frame_flags b) {
+    return static_cast<ats_frame_flags>(static_cast<uint32_t>(a)
+                                        & static_cast<uint32_t>(b));
+}
+
+constexpr ats_frame_flags operator~(ats_frame_flags a) {
+    return static_cast<ats_frame_flags>(~static_cast<uint32_t>(a));
+}
+
+inline ats_frame_flags &operator|=(ats_frame_flags &a, ats_frame_flags b) {
+    return a = a | b;
+}
+
+inline ats_frame_flags &operator&=(ats_frame_flags &a, ats_frame_flags b) {
+    return a = a & b;
+}
+
+/// Describes one frame
+struct ats_frame_entry {
+    uint32_t frame_count;
+
+    /// Record number of the first record of the frame
+    uint32_t first_record_number;
+
+    /// Number of records in the frame
+    uint32_t record_count;
+
+    /// Anomalies of the frame
+    ats_frame_flags flags;
+
+    /// Trigger timestamps of the first and last records of the frame
+    uint64_t start_timestamp;
+    uint64_t end_timestamp;
+};
+
+/// State of a frame indexer, carried from one batch of footers to the next
+struct ats_frame_indexer {
+    /// Number of records expected in each frame, or 0 to disable the check
+    uint32_t records_per_frame;
+
+    /// True if `current` holds the frame being assembled
+    bool has_current;
+
+    /// Frame being assembled. Its flags do not include
+    /// `ats_frame_flags::incomplete`, which is only known once the frame
+    /// ends.
+    ats_frame_entry current;
+
+    /// Record number of the last footer consumed
+    uint32_t last_record_number;
+
+    /// True if at least one frame has been emitted
+    bool has_previous;
+
+    /// Frame count of the last frame emitted
+    uint32_t previous_frame_count;
+};
+
+/// Outcome of a call to `ats_index_frames()`
+struct ats_frame_index_result {
+    /// Number of footers consumed. Lower than the number of footers passed if
+    /// the frame table is full.
+    size_t footers_consumed;
+
+    /// Number of frames written to the frame table
+    size_t frames_written;
+};
+
+/// Creates an indexer. `records_per_frame` is the expected number of records
+/// in each frame, or 0 if it is not known.
+ats_frame_indexer ATSFOOTERSLIB
+ats_make_frame_indexer(uint32_t records_per_frame = 0);
+
+/// Consumes footers and writes an entry to `frames` for each frame that ends
+/// within them. A frame ends when a footer with a different frame count
+/// arrives. Stops early if `frames` is full; call again with the remaining
+/// footers.
+ats_frame_index_result ATSFOOTERSLIB
+ats_index_frames(ats_frame_indexer *indexer,
+                 span<const ats_footer_type_0> footers,
+                 span<ats_frame_entry> frames);
+
+ats_frame_index_result ATSFOOTERSLIB
+ats_index_frames(ats_frame_indexer *indexer,
+                 span<const ats_footer_type_1> footers,
+                 span<ats_frame_entry> frames);
+
+/// Emits the frame being assembled, typically at the end of an acquisition.
+/// Returns false if there is none.
+bool ATSFOOTERSLIB ats_flush_frame_index(ats_frame_indexer *indexer,
+                                         ats_frame_entry *frame);
+
+#endif // ATS_FOOTERS_FRAMES
@@ -0,0 +1,111 @@
+#ifndef ATS_FOOTERS_LATENCY
+#define ATS_FOOTERS_LATENCY
+
+///
+/// @file
+///
+/// Correlation of board trigger timestamps with the host's monotonic clock, to
+/// measure how far behind the triggers data processing runs.
+///
+/// Each time a buffer is handed to the parser, the host time is paired with
+/// the timestamp of the buffer's last trigger, and a linear model from board
+/// ticks to host time is fitted over these pairs. Hand-over happens some time
+/// after the trigger, so the model absorbs the average acquisition and
+/// transfer delay; latencies are measured from the estimated hand-over time of
+/// each trigger.
+///
+
+#include <cstddef>
+#include <cstdint>
+
+#include "atsfooters.hpp"
+
+/// Number of buckets of the latency histogram. Bucket `4 * k + s` holds
+/// latencies in the `s`-th quarter of [2^k, 2^(k+1)) nanoseconds.
+const size_t ats_latency_histogram_bucket_count = 256;
+
+/// Parameters of a clock correlator
+struct ats_clock_correlator_configuration {
+    /// Nominal frequency of the trigger timestamp counter, used until enough
+    /// buffers have been seen to fit the model
+    double ticks_per_second;
+
+    /// Weight of past buffers relative to the latest one in the model, in
+    /// (0, 1]. Values below 1 let the model follow clock drift; 1 weighs all
+    /// buffers equally.
+    double forgetting_factor;
+};
+
+/// Running board-tick to host-time model, and latency histogram
+struct ats_clock_correlator {
+    ats_clock_correlator_configuration configuration;
+
+    /// Number of buffers correlated
+    uint64_t buffer_count;
+
+    /// Origin of the model. Ticks and host times are stored relative to it.
+    uint64_t reference_ticks;
+    int64_t reference_host_ns;
+
+    /// Exponentially weighted means, variance and covariance of tick counts
+    /// (`x`) and host times (`y`), relative to the origin
+    double weight;
+    double mean_x;
+    double mean_y;
+    double m2_x;
+    double co_moment_xy;
+
+    /// Current model: `host_ns = reference_host_ns + intercept_ns +
+    /// slope_ns_per_tick * (ticks - reference_ticks)`
+    double intercept_ns;
+    double slope_ns_per_tick;
+
+    /// Histogram of the trigger-to-parse latencies of all footers. Negative
+    /// latencies are counted in bucket 0.
+    uint64_t latency_histogram[ats_latency_histogram_bucket_count];
+    uint64_t latency_count;
+};
+
+/// Trigger-to-parse latencies of the footers of one buffer, in nanoseconds
+struct ats_buffer_latency {
+    int64_t min_ns;
+    int64_t p50_ns;
+    int64_t p99_ns;
+    int64_t max_ns;
+};
+
+/// Current time of the host's monotonic clock (`CLOCK_MONOTONIC` on Linux), in
+/// nanoseconds
+int64_t ATSFOOTERSLIB ats_host_time_ns();
+
+/// Creates a correlator. Throws if the configuration is invalid.
+ats_clock_correlator ATSFOOTERSLIB
+ats_make_clock_correlator(ats_clock_correlator_configuration configuration);
+
+/// Records that the buffer whose footers have the unwrapped timestamps
+/// `ticks` (see `ats_unwrap_timestamps()`) was handed to the parser at
+/// `handover_ns` and fully parsed at `parsed_ns`, both host times from
+/// `ats_host_time_ns()`. Updates the model, then returns the latencies of the
+/// buffer's footers. `ticks` must be in increasing order.
+ats_buffer_latency ATSFOOTERSLIB
+ats_correlate_buffer(ats_clock_correlator *correlator,
+                     span<const uint64_t> ticks, int64_t handover_ns,
+                     int64_t parsed_ns);
+
+/// Estimates the host time, in nanoseconds, at which the buffer holding the
+/// trigger with unwrapped timestamp `ticks` was handed over
+inline int64_t ats_estimate_host_time_ns(const ats_clock_correlator &correlator,
+                                         uint64_t ticks) {
+    const double x = static_cast<double>(
+        static_cast<int64_t>(ticks - correlator.reference_ticks));
+    return correlator.reference_host_ns
+           + static_cast<int64_t>(correlator.intercept_ns
+                                  + correlator.slope_ns_per_tick * x);
+}
+
+/// Latency below which a fraction `p` of all footer latencies fall, in
+/// nanoseconds. The result has a resolution of about 12%.
+int64_t ATSFOOTERSLIB
+ats_latency_percentile(const ats_clock_correlator &correlator, double p);
+
+#endif // ATS_FOOTERS_LATENCY
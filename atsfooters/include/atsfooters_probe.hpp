@@ -0,0 +1,86 @@
+#ifndef ATS_FOOTERS_PROBE
+#define ATS_FOOTERS_PROBE
+
+///
+/// @file
+///
+/// Recovery of footers from buffers whose configuration is unknown or
+/// slightly wrong, or which are truncated or corrupted.
+///
+/// These functions look for footers stored as contiguous 16-byte blocks at a
+/// constant stride. This is the case for all boards with a single active
+/// channel, and for boards that store footers in raw buffer memory (FIFO
+/// acquisitions). Footers that are split across interleaved channels cannot be
+/// found this way; use `ats_check_footer_configuration()` to test candidate
+/// configurations instead.
+///
+
+#include <cstddef>
+#include <cstdint>
+
+#include "atsfooters.hpp"
+
+/// Location of footers stored contiguously at a constant stride in a buffer
+struct ats_footer_alignment {
+    /// Offset of the first footer from the start of the buffer, in bytes
+    size_t first_footer_offset_bytes;
+
+    /// Distance between consecutive footers, in bytes. This is the size of
+    /// the records of all channels acquired for one trigger.
+    size_t stride_bytes;
+
+    /// Number of consecutive plausible footers found at this alignment,
+    /// starting with the first
+    size_t confirmed_footer_count;
+};
+
+/// Outcome of `ats_scan_footers()`
+struct ats_footer_scan_result {
+    /// Number of footers written to the output array
+    size_t footers_parsed;
+
+    /// Number of times the scan lost track of footers and searched for them
+    size_t resync_count;
+
+    /// Number of bytes skipped while searching for footers
+    size_t bytes_skipped;
+};
+
+/// Searches the beginning of `data` for footers of type `footer_type`, i.e.
+/// 16-byte blocks with a valid type byte, consecutive record numbers and
+/// increasing timestamps at a constant stride of at most `max_stride_bytes`.
+/// Only the first `4 * max_stride_bytes` bytes are searched; the alignment
+/// that is found is then confirmed over the rest of `data`.
+///
+/// Returns false if no alignment with at least three consecutive footers is
+/// found.
+bool ATSFOOTERSLIB ats_probe_footer_alignment(
+    span<char> data, ats_footer_type footer_type,
+    ats_footer_alignment *alignment, size_t max_stride_bytes = 1 << 20);
+
+/// Computes the alignment of footers that an acquisition configuration
+/// implies. `confirmed_footer_count` is set to 0. Returns false if footers are
+/// not stored contiguously at a constant stride with this configuration.
+bool ATSFOOTERSLIB ats_get_footer_alignment(
+    ats_footer_configuration configuration, ats_footer_alignment *alignment);
+
+/// Returns the number of leading footers of `data` that are plausible with
+/// `configuration`: of the right type, with consecutive record numbers and
+/// increasing timestamps. At most `footer_count` footers are checked.
+size_t ATSFOOTERSLIB ats_check_footer_configuration(
+    span<char> data, ats_footer_configuration configuration,
+    size_t footer_count);
+
+/// Parses footers at `alignment` until `footers` is full or the end of `data`
+/// is reached. Whenever the footer at the expected location is not plausible,
+/// the scan searches forward for the next pair of footers one stride apart
+/// and resumes from there, instead of failing.
+ats_footer_scan_result ATSFOOTERSLIB
+ats_scan_footers(span<char> data, ats_footer_alignment alignment,
+                 span<ats_footer_type_0> footers);
+
+ats_footer_scan_result ATSFOOTERSLIB
+ats_scan_footers(span<char> data, ats_footer_alignment alignment,
+                 span<ats_footer_type_1> footers);
+
+#endif // ATS_FOOTERS_PROBE
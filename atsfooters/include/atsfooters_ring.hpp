@@ -0,0 +1,80 @@
+#ifndef ATS_FOOTERS_RING
+#define ATS_FOOTERS_RING
+
+///
+/// @file
+///
+/// Single-producer, multiple-consumer ring buffer of decoded footers living in
+/// POSIX shared memory. The acquisition process publishes footers without ever
+/// waiting for readers. Monitoring processes map the ring read-only, consume
+/// footers at their own pace and are told how many footers they missed if they
+/// fall more than one ring capacity behind.
+///
+/// Only available on POSIX platforms, where the library defines
+/// `ATS_HAVE_RING` for its users.
+///
+
+#include <cstddef>
+#include <cstdint>
+
+#include "atsfooters.hpp"
+
+/// Handle to a shared-memory footer ring, either as the publisher (see
+/// `ats_footer_ring_create()`) or as a subscriber (see
+/// `ats_footer_ring_open()`)
+struct ats_footer_ring;
+
+/// Outcome of a call to `ats_footer_ring_read()`
+struct ats_footer_ring_read_result {
+    /// Number of footers written to the output array
+    size_t footers_read;
+
+    /// Number of footers that were overwritten by the publisher before this
+    /// subscriber could read them, and are therefore lost
+    uint64_t footers_lost;
+};
+
+/// Creates a ring named `name` (e.g. "/my-acquisition") for publishing
+/// footers of type `footer_type`, replacing any existing ring with the same
+/// name. `capacity` is the number of footers kept in the ring and must be a
+/// power of two.
+ats_footer_ring *ATSFOOTERSLIB ats_footer_ring_create(
+    const char *name, ats_footer_type footer_type, size_t capacity);
+
+/// Maps an existing ring read-only as a subscriber. Reading starts with the
+/// next footer that the publisher writes.
+ats_footer_ring *ATSFOOTERSLIB ats_footer_ring_open(const char *name);
+
+/// Unmaps the ring and releases the handle. The shared-memory object itself
+/// remains until `ats_footer_ring_unlink()` is called.
+void ATSFOOTERSLIB ats_footer_ring_close(ats_footer_ring *ring);
+
+/// Removes the shared-memory object backing the ring named `name`. Processes
+/// that have the ring mapped keep access to it until they close it.
+void ATSFOOTERSLIB ats_footer_ring_unlink(const char *name);
+
+/// Type of the footers that the ring holds
+ats_footer_type ATSFOOTERSLIB
+ats_footer_ring_footer_type(const ats_footer_ring *ring);
+
+/// Number of footers that the ring holds
+size_t ATSFOOTERSLIB ats_footer_ring_capacity(const ats_footer_ring *ring);
+
+/// Appends `footers` to the ring. Never blocks. Throws if `ring` was not
+/// returned by `ats_footer_ring_create()`.
+void ATSFOOTERSLIB ats_footer_ring_publish(
+    ats_footer_ring *ring, span<const ats_footer_type_0> footers);
+
+void ATSFOOTERSLIB ats_footer_ring_publish(
+    ats_footer_ring *ring, span<const ats_footer_type_1> footers);
+
+/// Reads up to `footers.size()` footers that were published since the last
+/// read. Never blocks; returns zero footers if none are available. Throws if
+/// `ring` was not returned by `ats_footer_ring_open()`.
+ats_footer_ring_read_result ATSFOOTERSLIB
+ats_footer_ring_read(ats_footer_ring *ring, span<ats_footer_type_0> footers);
+
+ats_footer_ring_read_result ATSFOOTERSLIB
+ats_footer_ring_read(ats_footer_ring *ring, span<ats_footer_type_1> footers);
+
+#endif // ATS_FOOTERS_RING
@@ -0,0 +1,115 @@
+#ifndef ATS_FOOTERS_SIM
+#define ATS_FOOTERS_SIM
+
+///
+/// @file
+///
+/// Virtual board that generates DMA buffers with valid footers, to load-test
+/// footer parsing pipelines without hardware. Buffers can be generated one at
+/// a time with `ats_fill_simulated_buffer()`, or streamed at a given trigger
+/// rate through a rotation of buffers with `ats_run_simulation()`.
+///
+/// Only footers are written to buffers; sample data is left as is.
+///
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "atsfooters.hpp"
+
+/// Parameters of a simulated acquisition
+struct ats_simulator_configuration {
+    /// Board type, data layout and buffer geometry
+    ats_footer_configuration footers;
+
+    /// Trigger rate, in triggers per second
+    double trigger_rate;
+
+    /// Trigger timestamp increment between consecutive triggers
+    uint64_t ticks_per_trigger;
+
+    /// Number of records in each frame. Set to 0 to keep frame counts at 0.
+    uint32_t records_per_frame;
+
+    /// Number of DMA buffers in rotation between the board and the parser
+    size_t buffer_count;
+
+    /// Number of DMA buffers to acquire
+    size_t buffers_per_acquisition;
+
+    /// Probability that a trigger does not produce a record. Dropped records
+    /// leave gaps in record numbers and timestamps.
+    double drop_probability;
+
+    /// Probability that a footer is written with an invalid type
+    double corrupt_probability;
+
+    /// Number of threads that consume buffers in `ats_run_simulation()`
+    size_t parser_thread_count;
+
+    /// Seed of the pseudo-random number generator used by
+    /// `ats_run_simulation()`
+    uint64_t seed;
+};
+
+/// State of a simulated board, carried from one buffer to the next
+struct ats_simulator_state {
+    /// Number of triggers so far, including those of dropped records
+    uint64_t trigger_count;
+
+    /// State of the pseudo-random number generator used to drop records and
+    /// corrupt footers
+    uint64_t random_state;
+};
+
+/// Anomalies injected in a simulated buffer
+struct ats_simulated_buffer_stats {
+    size_t records_dropped;
+    size_t footers_corrupted;
+};
+
+/// Outcome of `ats_run_simulation()`
+struct ats_simulation_report {
+    /// Number of buffers that the board filled
+    size_t buffers_acquired;
+
+    /// Number of buffers that the board could not fill because all buffers
+    /// were still waiting to be parsed. The triggers of these buffers are lost.
+    size_t buffer_overruns;
+
+    /// Number of buffers for which the consumer threw an exception
+    size_t parse_errors;
+
+    uint64_t records_dropped;
+    uint64_t footers_corrupted;
+
+    /// Duration of the whole simulation
+    double elapsed_seconds;
+
+    /// Time from the moment the board hands a buffer over to the end of its
+    /// parsing, in seconds
+    double latency_p50_seconds;
+    double latency_p99_seconds;
+    double latency_max_seconds;
+};
+
+/// Creates the state of a board at the start of an acquisition
+ats_simulator_state ATSFOOTERSLIB ats_make_simulator_state(uint64_t seed);
+
+/// Writes the footers of the next DMA buffer of the acquisition to `data`,
+/// which must hold at least one buffer.
+ats_simulated_buffer_stats ATSFOOTERSLIB ats_fill_simulated_buffer(
+    span<char> data, const ats_simulator_configuration &configuration,
+    ats_simulator_state *state);
+
+/// Runs a simulated acquisition in real time. A board thread fills buffers at
+/// the configured trigger rate and hands them to `configuration.
+/// parser_thread_count` threads that call `consumer` on each buffer, then
+/// return the buffer to the board. If `consumer` is empty, buffers are parsed
+/// with `ats_parse_footers()`.
+ats_simulation_report ATSFOOTERSLIB
+ats_run_simulation(const ats_simulator_configuration &configuration,
+                   std::function<void(span<char>)> consumer = {});
+
+#endif // ATS_FOOTERS_SIM
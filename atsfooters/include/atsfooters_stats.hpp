@@ -0,0 +1,133 @@
+#ifndef ATS_FOOTERS_STATS
+#define ATS_FOOTERS_STATS
+
+///
+/// @file
+///
+/// Streaming statistics about trigger timing, computed from record footers in
+/// constant memory. Accumulators are plain structures: copying one takes a
+/// snapshot, and accumulators filled by different threads can be combined with
+/// `ats_merge_trigger_statistics()`.
+///
+
+#include <cstddef>
+#include <cstdint>
+
+#include "atsfooters.hpp"
+
+/// Number of buckets in the trigger interval histogram
+const size_t ats_trigger_histogram_bucket_count = 64;
+
+/// Number of sliding windows over which record rates are estimated
+const size_t ats_rate_window_count = 3;
+
+/// Number of slots that each rate window is divided into. Windows slide by one
+/// slot at a time.
+const size_t ats_rate_window_slot_count = 16;
+
+/// Parameters of a trigger statistics accumulator
+struct ats_trigger_statistics_configuration {
+    /// Frequency of the trigger timestamp counter, used to convert record rates
+    /// to records per second
+    double ticks_per_second;
+
+    /// Lower bound of the first histogram bucket, in timestamp ticks
+    uint64_t histogram_min_interval_ticks;
+
+    /// Width of each histogram bucket, in timestamp ticks
+    uint64_t histogram_bucket_width_ticks;
+
+    /// Length of each of the record rate windows, in timestamp ticks. Windows
+    /// are divided into slots whose width is rounded down to a power of two,
+    /// so the effective length may be up to half as long.
+    uint64_t rate_window_ticks[ats_rate_window_count];
+};
+
+/// Record counts over a sliding window of time, split into slots
+struct ats_rate_window {
+    /// Duration of each slot, in timestamp ticks
+    uint64_t slot_width_ticks;
+
+    /// Index of the most recent slot, counted in `slot_width_ticks` from
+    /// timestamp 0
+    uint64_t latest_slot;
+
+    /// Records counted in each slot. Slot `n` is stored at index
+    /// `n % ats_rate_window_slot_count`.
+    uint64_t record_counts[ats_rate_window_slot_count];
+};
+
+/// Running statistics about the triggers of an acquisition
+struct ats_trigger_statistics {
+    ats_trigger_statistics_configuration configuration;
+
+    /// Number of footers accumulated
+    uint64_t record_count;
+
+    /// Number of records inferred to be missing from gaps in record numbers
+    uint64_t missed_record_count;
+
+    /// Unwrapped timestamps of the first and last footers accumulated. The
+    /// first footer is counted from the last timestamp wraparound before it.
+    uint64_t first_timestamp;
+    uint64_t last_timestamp;
+
+    /// Raw 48-bit timestamp and record number of the last footer accumulated
+    uint64_t last_raw_timestamp;
+    uint32_t last_record_number;
+
+    /// Trigger interval statistics, in timestamp ticks. `interval_m2` is the
+    /// sum of squared differences from the mean (see Welford's algorithm).
+    /// Intervals that span missed records are not counted.
+    uint64_t interval_count;
+    uint64_t interval_min;
+    uint64_t interval_max;
+    double interval_mean;
+    double interval_m2;
+
+    /// Trigger interval histogram. Intervals lower than the first bucket are
+    /// counted in `histogram_underflow`, and those past the last bucket in
+    /// `histogram_overflow`.
+    uint64_t histogram[ats_trigger_histogram_bucket_count];
+    uint64_t histogram_underflow;
+    uint64_t histogram_overflow;
+
+    ats_rate_window rate_windows[ats_rate_window_count];
+};
+
+/// Creates an empty accumulator. Throws if the configuration is invalid.
+ats_trigger_statistics ATSFOOTERSLIB
+ats_make_trigger_statistics(ats_trigger_statistics_configuration configuration);
+
+/// Adds footers, in acquisition order, to the statistics
+void ATSFOOTERSLIB ats_update_trigger_statistics(
+    ats_trigger_statistics *statistics, span<const ats_footer_type_0> footers);
+
+void ATSFOOTERSLIB ats_update_trigger_statistics(
+    ats_trigger_statistics *statistics, span<const ats_footer_type_1> footers);
+
+/// Parses `footer_count` footers from `data` and adds them to the statistics,
+/// without writing the footers anywhere.
+void ATSFOOTERSLIB ats_accumulate_trigger_statistics(
+    span<char> data, ats_footer_configuration configuration,
+    size_t footer_count, ats_trigger_statistics *statistics);
+
+/// Adds the statistics of `source` to `destination`. Both accumulators must
+/// have the same configuration and cover the same acquisition, e.g. different
+/// buffers. Their first footers must be less than 2^47 ticks apart, so that
+/// the timestamps of both can be unwrapped in a common base, even if a
+/// wraparound happened between them. The interval between the last footer of
+/// one accumulator and the first footer of the other is not counted.
+void ATSFOOTERSLIB ats_merge_trigger_statistics(
+    ats_trigger_statistics *destination, const ats_trigger_statistics &source);
+
+/// Sample variance of the trigger interval, in squared ticks
+double ATSFOOTERSLIB
+ats_trigger_interval_variance(const ats_trigger_statistics &statistics);
+
+/// Estimates the record rate over the rate window number `window`, in records
+/// per second
+double ATSFOOTERSLIB ats_records_per_second(
+    const ats_trigger_statistics &statistics, size_t window);
+
+#endif // ATS_FOOTERS_STATS
@@ -0,0 +1,71 @@
+#ifndef ATS_FOOTERS_TIME
+#define ATS_FOOTERS_TIME
+
+///
+/// @file
+///
+/// Conversion of footer trigger timestamps to absolute time. Trigger
+/// timestamps are 48-bit counters that wrap around in long acquisitions. They
+/// count timestamp clock ticks, where the timestamp clock runs at the sample
+/// rate divided by a board-specific divisor.
+///
+
+#include <cstddef>
+#include <cstdint>
+
+#include "atsfooters.hpp"
+
+/// State carried from one buffer to the next by `ats_unwrap_timestamps()`. A
+/// zero-initialized state corresponds to the start of an acquisition.
+struct ats_timestamp_unwrap_state {
+    /// Ticks added to raw timestamps to account for the counter wraparounds
+    /// seen so far
+    uint64_t offset_ticks;
+
+    /// Raw value of the last timestamp unwrapped
+    uint64_t last_raw_timestamp;
+};
+
+/// Converts the 48-bit trigger timestamps of `footers` to monotonic 64-bit
+/// tick counts since the start of the acquisition, and writes them to
+/// `ticks`, which must be at least as large as `footers`.
+///
+/// To unwrap timestamps across consecutive buffers, pass the same `state` to
+/// each call. If `state` is NULL, `footers` are assumed to be the first
+/// footers of the acquisition.
+void ATSFOOTERSLIB
+ats_unwrap_timestamps(span<const ats_footer_type_0> footers,
+                      span<uint64_t> ticks,
+                      ats_timestamp_unwrap_state *state = nullptr);
+
+void ATSFOOTERSLIB
+ats_unwrap_timestamps(span<const ats_footer_type_1> footers,
+                      span<uint64_t> ticks,
+                      ats_timestamp_unwrap_state *state = nullptr);
+
+/// Same as the overloads taking footers, for raw timestamps
+void ATSFOOTERSLIB
+ats_unwrap_timestamps(span<const uint64_t> raw_timestamps,
+                      span<uint64_t> ticks,
+                      ats_timestamp_unwrap_state *state = nullptr);
+
+/// Converts tick counts to seconds, given the sample rate of the acquisition
+/// in samples per second, and the timestamp divisor of the board.
+void ATSFOOTERSLIB ats_ticks_to_seconds(span<const uint64_t> ticks,
+                                        double sample_rate,
+                                        uint32_t timestamp_divisor,
+                                        span<double> seconds);
+
+/// Converts tick counts to nanoseconds, rounded to the nearest nanosecond,
+/// ties to even. Results are exact to the nanosecond for the first 2^53 ns
+/// (about 104 days) of an acquisition, and saturate to `INT64_MAX` past
+/// 2^63 ns.
+///
+/// The conversions are written so that compilers can vectorize them with SSE2
+/// in optimized builds; `atsfooters-bench` measures their throughput.
+void ATSFOOTERSLIB ats_ticks_to_nanoseconds(span<const uint64_t> ticks,
+                                            double sample_rate,
+                                            uint32_t timestamp_divisor,
+                                            span<int64_t> nanoseconds);
+
+#endif // ATS_FOOTERS_TIME
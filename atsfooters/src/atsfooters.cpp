@@ -1,6 +1,9 @@
 #include "atsfooters.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <memory>
 #include <string.h>
 #include <vector>
 
@@ -67,38 +70,275 @@ ats_footer_type get_ats_footer_type(ats_board_type board_type) {
     }
 }
 
-void ats_parse_footers(span<char> data, ats_footer_configuration configuration,
-                       span<ats_footer_type_0> footers) {
-    // This is a "scratchpad". In order to avoid the overhead of memory
-    // allocation and deallocation, the variable is made static. It is
-    // thread-local to avoid race conditions.
-    static thread_local std::vector<ats_footer_internal> internals;
-    internals.resize(footers.size());
-
-    const auto locs
-        = get_internal_footer_locations(configuration, footers.size());
-    parse_internal_footers(
-        data, locs,
-        span<ats_footer_internal>(internals.data(), internals.size()));
+void ats_read_footer(span<char> data, const ats_footer_layout &layout,
+                     size_t index, ats_footer_type_0 *footer) {
+    ats_footer_internal internal;
+    read_internal_footer(data, layout, index, &internal);
+    parse_footer(&internal, footer);
+}
+
+void ats_read_footer(span<char> data, const ats_footer_layout &layout,
+                     size_t index, ats_footer_type_1 *footer) {
+    ats_footer_internal internal;
+    read_internal_footer(data, layout, index, &internal);
+    parse_footer(&internal, footer);
+}
+
+namespace {
+
+/// Shared implementation of the non-throwing `ats_parse_footers()`
+/// overloads. Footers are first gathered from `data` into `scratch` and their
+/// types checked, then decoded. This leaves `footers` untouched when any
+/// footer is invalid, and reads the strided DMA buffer memory only once.
+template <class T>
+int parse_footers(span<char> data, ats_footer_configuration configuration,
+                  span<T> footers, span<char> scratch,
+                  span<char> error_message, uint8_t expected_type) noexcept {
+    ats_footer_layout layout;
+    if (!get_footer_layout(configuration, &layout, error_message))
+        return -1;
+
+    if (!data.size()) {
+        format_error(error_message, "Error: data buffer size is 0");
+        return -1;
+    }
+
+    if (!data.data()) {
+        format_error(error_message, "Error: NULL data buffer");
+        return -1;
+    }
+
+    if (data.size() < footer_data_size(layout, footers.size())) {
+        format_error(error_message,
+                     "Error: data buffer is too small to hold %zu footers",
+                     footers.size());
+        return -1;
+    }
+
+    void *aligned = scratch.data();
+    size_t space = scratch.size();
+    if (!std::align(alignof(ats_footer_internal),
+                    footers.size() * sizeof(ats_footer_internal), aligned,
+                    space)) {
+        format_error(error_message,
+                     "Error: scratch buffer is too small to parse %zu footers",
+                     footers.size());
+        return -1;
+    }
+    auto internals = static_cast<ats_footer_internal *>(aligned);
+
+    for (size_t i = 0; i < footers.size(); i++) {
+        read_internal_footer(data, layout, i, &internals[i]);
+        if (internals[i].type != expected_type) {
+            format_error(error_message,
+                         "Error: Footer type %d is not the value expected",
+                         int(internals[i].type));
+            return -1;
+        }
+    }
     for (size_t i = 0; i < footers.size(); i++)
         parse_footer(&internals[i], &footers[i]);
+    return 0;
 }
 
-void ats_parse_footers(span<char> data, ats_footer_configuration configuration,
-                       span<ats_footer_type_1> footers) {
+template <class T>
+int parse_footers(span<char> data, ats_footer_configuration configuration,
+                  span<T> footers, std::pmr::memory_resource *resource,
+                  span<char> error_message) noexcept {
+    if (!resource) {
+        format_error(error_message, "Error: NULL memory resource");
+        return -1;
+    }
+
+    const size_t size = ats_footer_scratch_size(footers.size());
+    void *scratch;
+    try {
+        scratch = resource->allocate(size, alignof(ats_footer_internal));
+    } catch (...) {
+        format_error(error_message,
+                     "Error: could not allocate %zu bytes of scratch memory",
+                     size);
+        return -1;
+    }
+    const int result = ats_parse_footers(
+        data, configuration, footers,
+        span<char>(static_cast<char *>(scratch), size), error_message);
+    resource->deallocate(scratch, size, alignof(ats_footer_internal));
+    return result;
+}
+
+/// Shared implementation of the throwing `ats_parse_footers()` overloads
+template <class T>
+void parse_footers(span<char> data, ats_footer_configuration configuration,
+                   span<T> footers) {
     // This is a "scratchpad". In order to avoid the overhead of memory
     // allocation and deallocation, the variable is made static. It is
-    // thread-local to avoid race conditions.
-    static thread_local std::vector<ats_footer_internal> internals;
-    internals.resize(footers.size());
-
-    const auto locs
-        = get_internal_footer_locations(configuration, footers.size());
-    parse_internal_footers(
-        data, locs,
-        span<ats_footer_internal>(internals.data(), internals.size()));
-    for (size_t i = 0; i < footers.size(); i++)
-        parse_footer(&internals[i], &footers[i]);
+    // thread-local to avoid race conditions. It only grows, so each thread
+    // keeps 16 bytes per footer of its largest call until it exits.
+    static thread_local std::vector<char> scratch;
+    const size_t scratch_size = ats_footer_scratch_size(footers.size());
+    if (scratch.size() < scratch_size)
+        scratch.resize(scratch_size);
+
+    char error_message[256];
+    if (ats_parse_footers(data, configuration, footers,
+                          span<char>(scratch.data(), scratch.size()),
+                          span<char>(error_message, sizeof(error_message))))
+        throw std::runtime_error(error_message);
+}
+
+} // namespace
+
+void ats_parse_footers(span<char> data, ats_footer_configuration configuration,
+                       span<ats_footer_type_0> footers) {
+    parse_footers(data, configuration, footers);
+}
+
+void ats_parse_footers(span<char> data, ats_footer_configuration configuration,
+                       span<ats_footer_type_1> footers) {
+    parse_footers(data, configuration, footers);
+}
+
+size_t ats_footer_scratch_size(size_t footer_count) {
+    return footer_count * sizeof(ats_footer_internal)
+           + alignof(ats_footer_internal) - 1;
+}
+
+int ats_parse_footers(span<char> data, ats_footer_configuration configuration,
+                      span<ats_footer_type_0> footers, span<char> scratch,
+                      span<char> error_message) noexcept {
+    return parse_footers(data, configuration, footers, scratch, error_message,
+                         0);
+}
+
+int ats_parse_footers(span<char> data, ats_footer_configuration configuration,
+                      span<ats_footer_type_1> footers, span<char> scratch,
+                      span<char> error_message) noexcept {
+    return parse_footers(data, configuration, footers, scratch, error_message,
+                         1);
+}
+
+int ats_parse_footers(span<char> data, ats_footer_configuration configuration,
+                      span<ats_footer_type_0> footers,
+                      std::pmr::memory_resource *resource,
+                      span<char> error_message) noexcept {
+    return parse_footers(data, configuration, footers, resource,
+                         error_message);
+}
+
+int ats_parse_footers(span<char> data, ats_footer_configuration configuration,
+                      span<ats_footer_type_1> footers,
+                      std::pmr::memory_resource *resource,
+                      span<char> error_message) noexcept {
+    return parse_footers(data, configuration, footers, resource,
+                         error_message);
+}
+
+namespace {
+
+/// Shared implementation of the `ats_parse_analog_values` overloads. `convert`
+/// turns a (possibly fractional, for means) analog value into an output value.
+template <class T, class Convert>
+size_t parse_analog_values(span<char> data,
+                           ats_footer_configuration configuration,
+                           size_t footer_count, span<T> values,
+                           size_t decimation_factor,
+                           ats_analog_reduction reduction, Convert convert) {
+    if (get_ats_footer_type(configuration.board_type)
+        != ats_footer_type::type_1)
+        throw std::runtime_error(
+            "Error: board type does not generate analog values in footers");
+
+    if (!decimation_factor)
+        throw std::runtime_error("Error: decimation factor is 0");
+
+    const size_t value_count
+        = (footer_count + decimation_factor - 1) / decimation_factor;
+    if (values.size() < value_count)
+        throw std::runtime_error("Error: analog value array is too small");
+
+    if (!footer_count)
+        return 0;
+
+    if (!data.size())
+        throw std::runtime_error("Error: data buffer size is 0");
+
+    if (!data.data())
+        throw std::runtime_error("Error: NULL data buffer");
+
+    const auto layout = ats_get_footer_layout(configuration);
+    if (data.size() < footer_data_size(layout, footer_count))
+        throw std::runtime_error(
+            "Error: data buffer is too small to hold the footers");
+
+    ats_footer_internal internal;
+    for (size_t v = 0; v < value_count; v++) {
+        const size_t first = v * decimation_factor;
+        const size_t last = std::min(first + decimation_factor, footer_count);
+        int16_t min = INT16_MAX;
+        int16_t max = INT16_MIN;
+        int64_t sum = 0;
+        for (size_t i = first; i < last; i++) {
+            read_internal_footer(data, layout, i, &internal);
+            check_footer_type(&internal, 1);
+            const int16_t value = parse_analog_value(&internal);
+            min = std::min(min, value);
+            max = std::max(max, value);
+            sum += value;
+        }
+        switch (reduction) {
+        case ats_analog_reduction::min:
+            values[v] = convert(min);
+            break;
+        case ats_analog_reduction::max:
+            values[v] = convert(max);
+            break;
+        case ats_analog_reduction::mean:
+            values[v] = convert(double(sum) / double(last - first));
+            break;
+        default:
+            throw std::runtime_error("Error: invalid analog reduction");
+        }
+    }
+    return value_count;
+}
+
+} // namespace
+
+size_t ats_parse_analog_values(span<char> data,
+                               ats_footer_configuration configuration,
+                               size_t footer_count, span<int16_t> values,
+                               size_t decimation_factor,
+                               ats_analog_reduction reduction) {
+    return parse_analog_values(
+        data, configuration, footer_count, values, decimation_factor,
+        reduction, [](double value) { return int16_t(std::lround(value)); });
+}
+
+size_t ats_parse_analog_values(span<char> data,
+                               ats_footer_configuration configuration,
+                               size_t footer_count, span<float> values,
+                               float scale, size_t decimation_factor,
+                               ats_analog_reduction reduction) {
+    return parse_analog_values(
+        data, configuration, footer_count, values, decimation_factor,
+        reduction, [scale](double value) { return float(value * scale); });
+}
+
+int c_get_ats_footer_type(ats_board_type board_type,
+                          ats_footer_type *footer_type, char *error_message,
+                          size_t error_message_max_size) {
+    try {
+        if (!footer_type)
+            throw std::runtime_error("Error: NULL footer type");
+        *footer_type = get_ats_footer_type(board_type);
+        return 0;
+    } catch (const std::exception &e) {
+        if (error_message) {
+            strncpy(error_message, e.what(), error_message_max_size);
+        }
+        return -1;
+    }
 }
 
 int c_ats_parse_footers_type_0(char *data, size_t data_size_bytes,
@@ -137,3 +377,24 @@ int c_ats_parse_footers_type_1(char *data, size_t data_size_bytes,
         return -1;
     }
 }
+
+int c_ats_parse_analog_values(char *data, size_t data_size_bytes,
+                              ats_footer_configuration configuration,
+                              size_t footer_count, int16_t *values,
+                              size_t value_count, size_t decimation_factor,
+                              ats_analog_reduction reduction,
+                              char *error_message,
+                              size_t error_message_max_size) {
+    try {
+        ats_parse_analog_values(span<char>((char *)data, data_size_bytes),
+                                configuration, footer_count,
+                                span<int16_t>(values, value_count),
+                                decimation_factor, reduction);
+        return 0;
+    } catch (const std::exception &e) {
+        if (error_message) {
+            strncpy(error_message, e.what(), error_message_max_size);
+        }
+        return -1;
+    }
+}
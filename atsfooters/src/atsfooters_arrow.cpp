@@ -0,0 +1,478 @@
+#include "atsfooters_arrow.hpp"
+
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+#include "atsfooters_internal.hpp"
+
+namespace {
+
+/// Minimal FlatBuffers encoder, sufficient for Arrow IPC metadata. Objects
+/// are laid out front to back: each table comes before the tables, vectors
+/// and strings that it refers to, so that references are forward offsets.
+class flatbuffer {
+  public:
+    flatbuffer() {
+        // Offset to the root table
+        reserve(4, 4);
+    }
+
+    const std::vector<char> &bytes() const { return m_bytes; }
+
+    /// Appends `size` zero bytes aligned to `alignment`, and returns their
+    /// position
+    size_t reserve(size_t size, size_t alignment) {
+        m_bytes.resize((m_bytes.size() + alignment - 1) / alignment
+                       * alignment);
+        const size_t position = m_bytes.size();
+        m_bytes.resize(position + size);
+        return position;
+    }
+
+    template <class T> void write(size_t position, T value) {
+        memcpy(&m_bytes[position], &value, sizeof(T));
+    }
+
+    /// Points the offset field at `position` to the object at `target`
+    void link(size_t position, size_t target) {
+        write(position, static_cast<uint32_t>(target - position));
+    }
+
+    /// Appends a table, preceded by its vtable. `field_sizes` holds the size
+    /// of each field in order of field id, or 0 for absent fields. The
+    /// position of each field is written to `field_positions`.
+    size_t table(std::initializer_list<size_t> field_sizes,
+                 size_t *field_positions) {
+        const size_t field_count = field_sizes.size();
+        const size_t vtable = reserve(4 + 2 * field_count, 2);
+        const size_t table = reserve(4, 4);
+        size_t id = 0;
+        for (const size_t size : field_sizes) {
+            uint16_t offset = 0;
+            if (size) {
+                field_positions[id] = reserve(size, size);
+                offset = static_cast<uint16_t>(field_positions[id] - table);
+            }
+            write(vtable + 4 + 2 * id, offset);
+            id++;
+        }
+        write(vtable, static_cast<uint16_t>(4 + 2 * field_count));
+        write(vtable + 2, static_cast<uint16_t>(m_bytes.size() - table));
+        write(table, static_cast<int32_t>(table - vtable));
+        return table;
+    }
+
+    /// Appends a vector of `count` elements of `element_size` bytes, aligned
+    /// to `alignment`. Returns the position of the vector, whose elements
+    /// start 4 bytes later.
+    size_t vector(size_t count, size_t element_size, size_t alignment) {
+        size_t position = reserve(0, 4);
+        while ((position + 4) % alignment)
+            position += 4;
+        m_bytes.resize(position);
+        reserve(4 + count * element_size, 4);
+        write(position, static_cast<uint32_t>(count));
+        return position;
+    }
+
+    size_t string(const char *value) {
+        const size_t length = strlen(value);
+        const size_t position = reserve(4 + length + 1, 4);
+        write(position, static_cast<uint32_t>(length));
+        memcpy(&m_bytes[position + 4], value, length);
+        return position;
+    }
+
+  private:
+    std::vector<char> m_bytes;
+};
+
+/// Values of the Arrow metadata enumerations and unions used here. See
+/// Schema.fbs and Message.fbs in the Arrow format specification.
+const int16_t metadata_version_v5 = 4;
+const uint8_t message_header_schema = 1;
+const uint8_t message_header_record_batch = 3;
+const uint8_t type_int = 2;
+const uint8_t type_bool = 6;
+
+/// Continuation marker that precedes each encapsulated message
+const uint32_t continuation_marker = 0xFFFFFFFF;
+
+const char file_magic[] = "ARROW1";
+const size_t file_magic_size = 6;
+
+/// Arrow requires 8-byte alignment of body buffers, and recommends 64. Message
+/// metadata is padded so that bodies start at this alignment, relative to the
+/// start of the output.
+const size_t buffer_alignment = 64;
+
+struct column {
+    const char *name;
+
+    /// 1 for booleans, which are stored as bitmaps
+    int32_t bit_width;
+    bool is_signed;
+};
+
+const column columns[] = {
+    {"trigger_timestamp", 64, false}, {"record_number", 32, false},
+    {"frame_count", 32, false},       {"aux_in_state", 1, false},
+    {"analog_value", 16, true},
+};
+
+size_t column_count(ats_footer_type footer_type) {
+    return footer_type == ats_footer_type::type_0 ? 4 : 5;
+}
+
+size_t align(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+/// Location of the buffers of a record batch, relative to the start of the
+/// message body. Each column has a validity bitmap followed by its values.
+struct body_layout {
+    size_t offsets[2 * sizeof(columns) / sizeof(column)];
+    size_t lengths[2 * sizeof(columns) / sizeof(column)];
+    size_t size;
+};
+
+body_layout get_body_layout(ats_footer_type footer_type, size_t row_count) {
+    body_layout layout{};
+    const size_t bitmap_length = (row_count + 7) / 8;
+    for (size_t c = 0; c < column_count(footer_type); c++) {
+        const size_t value_length
+            = columns[c].bit_width == 1 ? bitmap_length
+                                        : row_count * columns[c].bit_width / 8;
+        for (const size_t b : {2 * c, 2 * c + 1}) {
+            layout.offsets[b] = layout.size;
+            layout.lengths[b] = b == 2 * c ? bitmap_length : value_length;
+            layout.size += align(layout.lengths[b], buffer_alignment);
+        }
+    }
+    return layout;
+}
+
+/// Encodes a Schema table, and returns its position
+size_t encode_schema(flatbuffer *fb, ats_footer_type footer_type) {
+    size_t schema_fields[2];
+    const size_t schema = fb->table({2, 4}, schema_fields);
+    const size_t fields = fb->vector(column_count(footer_type), 4, 4);
+    fb->link(schema_fields[1], fields);
+
+    for (size_t c = 0; c < column_count(footer_type); c++) {
+        // name, nullable, type_type, type, dictionary, children
+        size_t field_fields[6];
+        const size_t field = fb->table({4, 1, 1, 4, 0, 4}, field_fields);
+        fb->link(fields + 4 + 4 * c, field);
+        fb->write(field_fields[1], uint8_t(1));
+
+        if (columns[c].bit_width == 1) {
+            fb->write(field_fields[2], type_bool);
+            fb->link(field_fields[3], fb->table({}, nullptr));
+        } else {
+            size_t int_fields[2];
+            fb->write(field_fields[2], type_int);
+            fb->link(field_fields[3], fb->table({4, 1}, int_fields));
+            fb->write(int_fields[0], columns[c].bit_width);
+            fb->write(int_fields[1], uint8_t(columns[c].is_signed));
+        }
+
+        fb->link(field_fields[0], fb->string(columns[c].name));
+        fb->link(field_fields[5], fb->vector(0, 4, 4));
+    }
+    return schema;
+}
+
+/// Encodes a Message table with a header of type `header_type`, and returns
+/// the position of the header field
+size_t encode_message(flatbuffer *fb, uint8_t header_type,
+                      size_t body_length) {
+    // version, header_type, header, bodyLength
+    size_t message_fields[4];
+    fb->link(0, fb->table({2, 1, 4, 8}, message_fields));
+    fb->write(message_fields[0], metadata_version_v5);
+    fb->write(message_fields[1], header_type);
+    fb->write(message_fields[3], static_cast<int64_t>(body_length));
+    return message_fields[2];
+}
+
+flatbuffer schema_message(ats_footer_type footer_type) {
+    flatbuffer fb;
+    const size_t header = encode_message(&fb, message_header_schema, 0);
+    fb.link(header, encode_schema(&fb, footer_type));
+    return fb;
+}
+
+/// Encodes a RecordBatch message. Null counts are left at 0; the position of
+/// the first FieldNode is written to `nodes_position` so that they can be
+/// filled in once the body is written.
+flatbuffer record_batch_message(ats_footer_type footer_type, size_t row_count,
+                                const body_layout &body,
+                                size_t *nodes_position) {
+    flatbuffer fb;
+    const size_t header = encode_message(&fb, message_header_record_batch,
+                                         body.size);
+
+    // length, nodes, buffers
+    size_t batch_fields[3];
+    fb.link(header, fb.table({8, 4, 4}, batch_fields));
+    fb.write(batch_fields[0], static_cast<int64_t>(row_count));
+
+    const size_t count = column_count(footer_type);
+    const size_t nodes = fb.vector(count, 16, 8);
+    fb.link(batch_fields[1], nodes);
+    for (size_t c = 0; c < count; c++)
+        fb.write(nodes + 4 + 16 * c, static_cast<int64_t>(row_count));
+    *nodes_position = nodes + 4;
+
+    const size_t buffers = fb.vector(2 * count, 16, 8);
+    fb.link(batch_fields[2], buffers);
+    for (size_t b = 0; b < 2 * count; b++) {
+        fb.write(buffers + 4 + 16 * b, static_cast<int64_t>(body.offsets[b]));
+        fb.write(buffers + 12 + 16 * b, static_cast<int64_t>(body.lengths[b]));
+    }
+    return fb;
+}
+
+/// Encodes the footer of the file format, for a file holding one record batch
+flatbuffer file_footer(ats_footer_type footer_type, size_t batch_offset,
+                       size_t batch_metadata_size, size_t batch_body_size) {
+    flatbuffer fb;
+
+    // version, schema, dictionaries, recordBatches
+    size_t footer_fields[4];
+    fb.link(0, fb.table({2, 4, 4, 4}, footer_fields));
+    fb.write(footer_fields[0], metadata_version_v5);
+    fb.link(footer_fields[1], encode_schema(&fb, footer_type));
+    fb.link(footer_fields[2], fb.vector(0, 24, 8));
+
+    const size_t batches = fb.vector(1, 24, 8);
+    fb.link(footer_fields[3], batches);
+    fb.write(batches + 4, static_cast<int64_t>(batch_offset));
+    fb.write(batches + 12, static_cast<int32_t>(batch_metadata_size));
+    fb.write(batches + 20, static_cast<int64_t>(batch_body_size));
+
+    // Keep whatever follows 8-byte aligned
+    fb.reserve(0, 8);
+    return fb;
+}
+
+/// Size of an encapsulated message that starts at `position` in the output,
+/// without its body. The metadata is padded so that the message ends on a
+/// multiple of `buffer_alignment`.
+size_t message_size(const flatbuffer &metadata, size_t position) {
+    return align(position + 8 + metadata.bytes().size(), buffer_alignment)
+           - position;
+}
+
+/// Writes an encapsulated message that starts at `position` in the output,
+/// without its body, and returns its size
+size_t write_message(const flatbuffer &metadata, size_t position,
+                     char *output) {
+    const size_t size = message_size(metadata, position);
+    const uint32_t metadata_length = static_cast<uint32_t>(size - 8);
+    memcpy(output, &continuation_marker, 4);
+    memcpy(output + 4, &metadata_length, 4);
+    memcpy(output + 8, metadata.bytes().data(), metadata.bytes().size());
+    memset(output + 8 + metadata.bytes().size(), 0,
+           size - 8 - metadata.bytes().size());
+    return size;
+}
+
+/// Accumulates bits into bytes of a bitmap, least significant bit first
+class bitmap_writer {
+  public:
+    explicit bitmap_writer(char *destination) : m_destination(destination) {}
+
+    void push(bool bit) {
+        m_byte |= static_cast<uint8_t>(bit) << (m_count % 8);
+        if (++m_count % 8 == 0) {
+            *m_destination++ = static_cast<char>(m_byte);
+            m_byte = 0;
+        }
+    }
+
+    void flush() {
+        if (m_count % 8)
+            *m_destination = static_cast<char>(m_byte);
+    }
+
+  private:
+    char *m_destination;
+    uint8_t m_byte = 0;
+    size_t m_count = 0;
+};
+
+/// Decodes footers into the buffers of a record batch body, and returns the
+/// number of null rows
+size_t write_body(span<char> data, const ats_footer_layout &layout,
+                  ats_footer_type footer_type, size_t footer_count,
+                  const body_layout &body, char *output) {
+    // Clear the padding after each buffer; the buffers themselves are
+    // entirely overwritten.
+    for (size_t b = 0; b < 2 * column_count(footer_type); b++)
+        memset(output + body.offsets[b] + body.lengths[b], 0,
+               align(body.lengths[b], buffer_alignment) - body.lengths[b]);
+
+    const uint8_t expected_type
+        = footer_type == ats_footer_type::type_0 ? 0 : 1;
+    auto trigger_timestamps
+        = reinterpret_cast<uint64_t *>(output + body.offsets[1]);
+    auto record_numbers
+        = reinterpret_cast<uint32_t *>(output + body.offsets[3]);
+    auto frame_counts = reinterpret_cast<uint32_t *>(output + body.offsets[5]);
+    auto analog_values = footer_type == ats_footer_type::type_1
+                             ? reinterpret_cast<int16_t *>(output
+                                                           + body.offsets[9])
+                             : nullptr;
+    bitmap_writer validity(output + body.offsets[0]);
+    bitmap_writer aux_in_states(output + body.offsets[7]);
+
+    size_t null_count = 0;
+    ats_footer_internal internal;
+    ats_footer_type_1 footer;
+    for (size_t i = 0; i < footer_count; i++) {
+        read_internal_footer(data, layout, i, &internal);
+        const bool valid = internal.type == expected_type;
+        if (valid) {
+            footer.trigger_timestamp = parse_trigger_timestamp(&internal);
+            footer.record_number = parse_record_number(&internal);
+            footer.frame_count
+                = (uint32_t)internal.fc_low + (internal.fc_high << 16);
+            footer.aux_in_state = internal.aux_and_pulsar_low & 0x01;
+            footer.analog_value = parse_analog_value(&internal);
+        } else {
+            footer = ats_footer_type_1{};
+            null_count++;
+        }
+        trigger_timestamps[i] = footer.trigger_timestamp;
+        record_numbers[i] = footer.record_number;
+        frame_counts[i] = footer.frame_count;
+        if (analog_values)
+            analog_values[i] = footer.analog_value;
+        validity.push(valid);
+        aux_in_states.push(footer.aux_in_state);
+    }
+    validity.flush();
+    aux_in_states.flush();
+
+    // All columns share the validity of the footer
+    for (size_t c = 1; c < column_count(footer_type); c++)
+        memcpy(output + body.offsets[2 * c], output + body.offsets[0],
+               body.lengths[0]);
+    return null_count;
+}
+
+} // namespace
+
+size_t ats_arrow_ipc_size(ats_footer_type footer_type, size_t footer_count,
+                          ats_arrow_format format) {
+    const auto body = get_body_layout(footer_type, footer_count);
+    size_t nodes_position;
+    const size_t schema_offset = format == ats_arrow_format::file ? 8 : 0;
+    const size_t batch_offset
+        = schema_offset
+          + message_size(schema_message(footer_type), schema_offset);
+    const size_t stream_end
+        = batch_offset
+          + message_size(record_batch_message(footer_type, footer_count, body,
+                                              &nodes_position),
+                         batch_offset)
+          + body.size + 8;
+    if (format == ats_arrow_format::stream)
+        return stream_end;
+
+    return stream_end
+           + file_footer(footer_type, 0, 0, 0).bytes().size() + 4
+           + file_magic_size;
+}
+
+size_t ats_export_arrow_ipc(span<char> data,
+                            ats_footer_configuration configuration,
+                            size_t footer_count, ats_arrow_format format,
+                            span<char> output) {
+    const auto footer_type = get_ats_footer_type(configuration.board_type);
+    const size_t size = ats_arrow_ipc_size(footer_type, footer_count, format);
+    if (output.size() < size)
+        throw std::runtime_error("Error: Arrow output buffer is too small");
+
+    if (footer_count && !data.size())
+        throw std::runtime_error("Error: data buffer size is 0");
+
+    if (footer_count && !data.data())
+        throw std::runtime_error("Error: NULL data buffer");
+
+    const auto layout = ats_get_footer_layout(configuration);
+    if (data.size() < footer_data_size(layout, footer_count))
+        throw std::runtime_error(
+            "Error: data buffer is too small to hold the footers");
+
+    char *out = output.data();
+    if (format == ats_arrow_format::file) {
+        memset(out, 0, 8);
+        memcpy(out, file_magic, file_magic_size);
+        out += 8;
+    }
+    out += write_message(schema_message(footer_type),
+                         static_cast<size_t>(out - output.data()), out);
+
+    const size_t batch_offset = static_cast<size_t>(out - output.data());
+    const auto body = get_body_layout(footer_type, footer_count);
+    size_t nodes_position;
+    const auto batch = record_batch_message(footer_type, footer_count, body,
+                                            &nodes_position);
+    const size_t batch_metadata_size = write_message(batch, batch_offset, out);
+    char *body_start = out + batch_metadata_size;
+    const size_t null_count
+        = footer_count ? write_body(data, layout, footer_type, footer_count,
+                                    body, body_start)
+                       : 0;
+    for (size_t c = 0; c < column_count(footer_type); c++) {
+        const int64_t nulls = static_cast<int64_t>(null_count);
+        memcpy(out + 8 + nodes_position + 16 * c + 8, &nulls, 8);
+    }
+    out = body_start + body.size;
+
+    // End-of-stream marker
+    const uint32_t zero = 0;
+    memcpy(out, &continuation_marker, 4);
+    memcpy(out + 4, &zero, 4);
+    out += 8;
+
+    if (format == ats_arrow_format::file) {
+        const auto footer = file_footer(footer_type, batch_offset,
+                                        batch_metadata_size, body.size);
+        const uint32_t footer_size
+            = static_cast<uint32_t>(footer.bytes().size());
+        memcpy(out, footer.bytes().data(), footer_size);
+        memcpy(out + footer_size, &footer_size, 4);
+        memcpy(out + footer_size + 4, file_magic, file_magic_size);
+        out += footer_size + 4 + file_magic_size;
+    }
+    return static_cast<size_t>(out - output.data());
+}
+
+size_t c_ats_arrow_ipc_size(ats_footer_type footer_type, size_t footer_count,
+                            ats_arrow_format format) {
+    return ats_arrow_ipc_size(footer_type, footer_count, format);
+}
+
+int c_ats_export_arrow_ipc(char *data, size_t data_size_bytes,
+                           ats_footer_configuration configuration,
+                           size_t footer_count, ats_arrow_format format,
+                           char *output, size_t output_size_bytes,
+                           char *error_message, size_t error_message_max_size) {
+    try {
+        ats_export_arrow_ipc(span<char>(data, data_size_bytes), configuration,
+                             footer_count, format,
+                             span<char>(output, output_size_bytes));
+        return 0;
+    } catch (const std::exception &e) {
+        if (error_message) {
+            strncpy(error_message, e.what(), error_message_max_size);
+        }
+        return -1;
+    }
+}
@@ -0,0 +1,98 @@
+#include "atsfooters_frames.hpp"
+
+#include <stdexcept>
+
+namespace {
+
+/// Footers store the frame count on 24 bits
+const uint32_t frame_count_mask = 0xFFFFFF;
+
+/// Finishes the current frame of `indexer` and writes it to `frame`
+void end_frame(ats_frame_indexer *indexer, ats_frame_entry *frame) {
+    *frame = indexer->current;
+    if (indexer->records_per_frame
+        && frame->record_count != indexer->records_per_frame)
+        frame->flags |= ats_frame_flags::incomplete;
+    indexer->has_previous = true;
+    indexer->previous_frame_count = frame->frame_count;
+    indexer->has_current = false;
+}
+
+template <class T>
+ats_frame_index_result index_frames(ats_frame_indexer *indexer,
+                                    span<const T> footers,
+                                    span<ats_frame_entry> frames) {
+    if (!indexer)
+        throw std::runtime_error("Error: NULL frame indexer");
+
+    ats_frame_index_result result{0, 0};
+    for (const auto &footer : footers) {
+        ats_frame_entry &current = indexer->current;
+        if (indexer->has_current && footer.frame_count != current.frame_count) {
+            if (result.frames_written == frames.size())
+                break;
+            end_frame(indexer, &frames[result.frames_written++]);
+        }
+
+        if (!indexer->has_current) {
+            current = ats_frame_entry{
+                footer.frame_count,
+                footer.record_number,
+                0,
+                ats_frame_flags::none,
+                footer.trigger_timestamp,
+                footer.trigger_timestamp,
+            };
+            if (indexer->has_previous
+                && footer.frame_count
+                       != ((indexer->previous_frame_count + 1)
+                           & frame_count_mask))
+                current.flags |= ats_frame_flags::out_of_order;
+            indexer->has_current = true;
+        }
+
+        // The last record number carries over from the previous frame, so
+        // that records missing at a frame boundary are flagged too
+        if ((indexer->has_previous || current.record_count)
+            && footer.record_number != indexer->last_record_number + 1)
+            current.flags |= ats_frame_flags::record_gap;
+
+        current.record_count++;
+        current.end_timestamp = footer.trigger_timestamp;
+        indexer->last_record_number = footer.record_number;
+        result.footers_consumed++;
+    }
+    return result;
+}
+
+} // namespace
+
+ats_frame_indexer ats_make_frame_indexer(uint32_t records_per_frame) {
+    ats_frame_indexer indexer{};
+    indexer.records_per_frame = records_per_frame;
+    return indexer;
+}
+
+ats_frame_index_result ats_index_frames(ats_frame_indexer *indexer,
+                                        span<const ats_footer_type_0> footers,
+                                        span<ats_frame_entry> frames) {
+    return index_frames(indexer, footers, frames);
+}
+
+ats_frame_index_result ats_index_frames(ats_frame_indexer *indexer,
+                                        span<const ats_footer_type_1> footers,
+                                        span<ats_frame_entry> frames) {
+    return index_frames(indexer, footers, frames);
+}
+
+bool ats_flush_frame_index(ats_frame_indexer *indexer,
+                           ats_frame_entry *frame) {
+    if (!indexer)
+        throw std::runtime_error("Error: NULL frame indexer");
+
+    if (!indexer->has_current)
+        return false;
+
+    end_frame(indexer, frame);
+    return true;
+}
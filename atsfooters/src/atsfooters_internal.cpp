@@ -1,47 +1,55 @@
 #include "atsfooters_internal.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <sstream>
 
 #include "utils.hpp"
 
-void parse_footer(const ats_footer_internal *source,
-                  ats_footer_type_0 *destination) {
-    if (source->type != 0) {
+void check_footer_type(const ats_footer_internal *source, uint8_t expected) {
+    if (source->type != expected) {
         std::ostringstream ostr;
         ostr << "Error: Footer type " << int(source->type)
              << " is not the value expected";
         throw std::runtime_error(ostr.str());
     }
+}
+
+int16_t parse_analog_value(const ats_footer_internal *source) {
+    uint16_t rawd
+        = (source->aux_and_pulsar_low & 0xF0) | (source->pulsar_high << 8);
+    return *reinterpret_cast<int16_t *>(&rawd);
+}
+
+uint64_t parse_trigger_timestamp(const ats_footer_internal *source) {
+    return (uint64_t)source->tt_low + ((uint64_t)source->tt_med << 16)
+           + ((uint64_t)source->tt_high << 32);
+}
+
+uint32_t parse_record_number(const ats_footer_internal *source) {
+    return (uint32_t)source->rn_low + (source->rn_high << 16);
+}
+
+void parse_footer(const ats_footer_internal *source,
+                  ats_footer_type_0 *destination) {
+    check_footer_type(source, 0);
 
     *destination = ats_footer_type_0{
-        (uint64_t)source->tt_low + ((uint64_t)source->tt_med << 16)
-            + ((uint64_t)source->tt_high << 32),
-        (uint32_t)source->rn_low + (source->rn_high << 16),
+        parse_trigger_timestamp(source), parse_record_number(source),
         (uint32_t)source->fc_low + (source->fc_high << 16),
         (source->aux_and_pulsar_low & 0x01) ? true : false};
 }
 
 void parse_footer(const ats_footer_internal *source,
                   ats_footer_type_1 *destination) {
-    if (source->type != 1) {
-        std::ostringstream ostr;
-        ostr << "Error: Footer type " << int(source->type)
-             << " is not the value expected";
-        throw std::runtime_error(ostr.str());
-    }
-
-    uint16_t rawd
-        = (source->aux_and_pulsar_low & 0xF0) | (source->pulsar_high << 8);
+    check_footer_type(source, 1);
 
     *destination = ats_footer_type_1{
-        (uint64_t)source->tt_low + ((uint64_t)source->tt_med << 16)
-            + ((uint64_t)source->tt_high << 32),
-        (uint32_t)source->rn_low + (source->rn_high << 16),
+        parse_trigger_timestamp(source), parse_record_number(source),
         (uint32_t)source->fc_low + (source->fc_high << 16),
         (source->aux_and_pulsar_low & 0x01) ? true : false,
-        *reinterpret_cast<int16_t *>(&rawd)};
+        parse_analog_value(source)};
 }
 
 size_t resolution_bits(ats_board_type board_type) {
@@ -95,10 +103,9 @@ size_t resolution_bits(ats_board_type board_type) {
     case ats_board_type::ats9628:
         return 16;
     default:
-        /// Invalid board type
-        assert(false);
+        // Invalid or unsupported board type
+        return 0;
     }
-    return 0;
 }
 
 size_t default_bytes_per_sample(ats_board_type board_type) {
@@ -129,189 +136,162 @@ size_t record_footer_block_size(ats_board_type board_type,
     }
 }
 
-record_footer_embedding get_record_footer_embedding(ats_board_type board_type,
-                                                    bool fifo) {
+ats_footer_embedding get_record_footer_embedding(ats_board_type board_type,
+                                                 bool fifo) {
     switch (board_type) {
     case ats_board_type::ats9130:
     case ats_board_type::ats9416:
     case ats_board_type::ats9364:
-        return record_footer_embedding::raw_buffer;
+        return ats_footer_embedding::raw_buffer;
     case ats_board_type::ats9146:
     case ats_board_type::ats9352:
     case ats_board_type::ats9353:
     case ats_board_type::ats9872:
-        return fifo ? record_footer_embedding::raw_buffer
-                    : record_footer_embedding::channel_data_one_per_channel;
+        return fifo ? ats_footer_embedding::raw_buffer
+                    : ats_footer_embedding::channel_data_one_per_channel;
     default:
-        return record_footer_embedding::channel_data_shared;
+        return ats_footer_embedding::channel_data_shared;
     }
 }
 
-std::ostream &operator<<(std::ostream &os,
-                         const contiguous_data_block_location &location) {
-    os << "{offset: " << location.offset_bytes
-       << ", size: " << location.size_bytes << "}";
-    return os;
-}
-
-void copy(span<char> source, contiguous_data_block_location location,
-          span<char> destination) {
-    assert(source.size() >= location.offset_bytes + location.size_bytes);
-    std::copy(source.data() + location.offset_bytes,
-              source.data() + location.offset_bytes + location.size_bytes,
-              destination.data());
-}
-
-std::ostream &operator<<(std::ostream &os,
-                         const data_block_location &location) {
-    bool first = true;
-    os << "{";
-    for (auto part : location.parts) {
-        if (first)
-            first = false;
-        else
-            os << ", ";
-        os << part;
+bool get_footer_layout(ats_footer_configuration configuration,
+                       ats_footer_layout *layout, span<char> error_message) {
+    if (configuration.data_domain != ats_data_domain::time
+        && configuration.data_domain != ats_data_domain::frequency) {
+        format_error(error_message, "Data domain %d is invalid",
+                     static_cast<int>(configuration.data_domain));
+        return false;
     }
-    os << "}";
-    return os;
-}
-
-void copy(span<char> source, data_block_location location,
-          span<char> destination) {
-    size_t offset = 0;
-    for (auto part : location.parts) {
-        copy(source, part, destination.subspan(offset));
-        offset += part.size_bytes;
+    const size_t bytes_per_sample
+        = default_bytes_per_sample(configuration.board_type);
+    if (!bytes_per_sample) {
+        format_error(error_message, "Error: board type %d is not supported",
+                     static_cast<int>(configuration.board_type));
+        return false;
     }
-}
 
-std::vector<data_block_location>
-get_internal_footer_locations(ats_footer_configuration configuration,
-                              size_t footer_count) {
     const size_t footer_block_size_bytes = record_footer_block_size(
         configuration.board_type, configuration.data_domain);
 
-    const size_t bytes_per_sample
-        = default_bytes_per_sample(configuration.board_type);
-
-    if (!configuration.bytes_per_record_per_channel)
-        throw std::runtime_error("Error: record size is 0");
+    if (!configuration.bytes_per_record_per_channel) {
+        format_error(error_message, "Error: record size is 0");
+        return false;
+    }
 
-    if (!configuration.records_per_buffer_per_channel)
-        throw std::runtime_error("Error: records per buffer is 0");
+    if (!configuration.records_per_buffer_per_channel) {
+        format_error(error_message, "Error: records per buffer is 0");
+        return false;
+    }
 
-    if (!configuration.active_channel_count)
-        throw std::runtime_error("Error: active channel count is 0");
+    if (!configuration.active_channel_count) {
+        format_error(error_message, "Error: active channel count is 0");
+        return false;
+    }
 
-    const size_t samples_per_record
-        = configuration.bytes_per_record_per_channel / bytes_per_sample;
     const auto records_per_buffer
         = configuration.records_per_buffer_per_channel;
     const auto record_size_bytes = configuration.bytes_per_record_per_channel;
     const auto active_channel_count = configuration.active_channel_count;
 
-    long long sample_stride_bytes = bytes_per_sample;
-    long long channel_stride_bytes = bytes_per_sample;
-    long long record_stride_bytes = record_size_bytes;
-    long long buffer_stride_bytes
+    layout->embedding = get_record_footer_embedding(configuration.board_type,
+                                                    configuration.fifo);
+    layout->bytes_per_sample = bytes_per_sample;
+    layout->active_channel_count = active_channel_count;
+    layout->records_per_buffer = records_per_buffer;
+    layout->record_size_bytes = record_size_bytes;
+    layout->samples_per_record = record_size_bytes / bytes_per_sample;
+    layout->footer_block_size_bytes = footer_block_size_bytes;
+    layout->sample_stride_bytes = bytes_per_sample;
+    layout->channel_stride_bytes = bytes_per_sample;
+    layout->record_stride_bytes = record_size_bytes;
+    layout->buffer_stride_bytes
         = record_size_bytes * records_per_buffer * active_channel_count;
     if (active_channel_count > 1) {
         switch (configuration.data_layout) {
         case ats_data_layout::sample_interleaved:
-            sample_stride_bytes = active_channel_count * bytes_per_sample;
-            channel_stride_bytes = bytes_per_sample;
-            record_stride_bytes = record_size_bytes * active_channel_count;
+            layout->sample_stride_bytes
+                = active_channel_count * bytes_per_sample;
+            layout->channel_stride_bytes = bytes_per_sample;
+            layout->record_stride_bytes
+                = record_size_bytes * active_channel_count;
             break;
         case ats_data_layout::record_interleaved:
-            sample_stride_bytes = bytes_per_sample;
-            channel_stride_bytes = record_size_bytes;
-            record_stride_bytes = record_size_bytes * active_channel_count;
+            layout->sample_stride_bytes = bytes_per_sample;
+            layout->channel_stride_bytes = record_size_bytes;
+            layout->record_stride_bytes
+                = record_size_bytes * active_channel_count;
             break;
         case ats_data_layout::buffer_interleaved:
-            sample_stride_bytes = bytes_per_sample;
-            channel_stride_bytes = records_per_buffer * record_size_bytes;
-            record_stride_bytes = record_size_bytes;
+            layout->sample_stride_bytes = bytes_per_sample;
+            layout->channel_stride_bytes
+                = records_per_buffer * record_size_bytes;
+            layout->record_stride_bytes = record_size_bytes;
             break;
         default:
-            std::ostringstream sstr;
-            sstr << "Error: data layout "
-                 << static_cast<int>(configuration.data_layout) << " invalid";
-            throw std::runtime_error(sstr.str());
+            format_error(error_message, "Error: data layout %d invalid",
+                         static_cast<int>(configuration.data_layout));
+            return false;
         }
     }
 
-    const auto embedding = get_record_footer_embedding(configuration.board_type,
-                                                       configuration.fifo);
-
-    if (!record_size_bytes)
-        throw std::runtime_error("Error: Record size is 0");
-
-    const size_t footer_block_size_samples_per_channel
-        = footer_block_size_bytes / active_channel_count / bytes_per_sample;
-    const size_t footer_block_size_samples
-        = footer_block_size_bytes / bytes_per_sample;
-    const int bytes_per_footer = 16;
-    const int samples_per_footer
-        = static_cast<int>(bytes_per_footer / bytes_per_sample);
-    std::vector<data_block_location> output(footer_count);
-    for (size_t footer = 0; footer < footer_count; footer++) {
-        const size_t r = footer % records_per_buffer;
-        const size_t buf = footer / records_per_buffer;
-
-        switch (embedding) {
-        case record_footer_embedding::channel_data_shared:
-            for (size_t c = 0; c < active_channel_count; c++) {
-                for (size_t s = 0;
-                     s < samples_per_footer / active_channel_count; s++) {
-                    const size_t source_offset = (size_t)(
-                        buf * buffer_stride_bytes + r * record_stride_bytes
-                        + c * channel_stride_bytes
-                        + (samples_per_record
-                           - footer_block_size_samples_per_channel + s)
-                              * sample_stride_bytes);
-                    output[footer].parts.push_back({
-                        source_offset,
-                        bytes_per_sample,
-                    });
-                }
-            }
-            break;
-        case record_footer_embedding::raw_buffer:
-            output[footer].parts.push_back(
-                {buf * buffer_stride_bytes
-                     + (r + 1) * record_size_bytes * active_channel_count
-                     - footer_block_size_bytes,
-                 16});
-            break;
-        case record_footer_embedding::channel_data_one_per_channel:
-            for (size_t s = 0; s < samples_per_footer; s++) {
-                const size_t source_offset = (size_t)(
-                    buf * buffer_stride_bytes + r * record_stride_bytes
-                    + (samples_per_record - footer_block_size_samples + s)
-                          * sample_stride_bytes);
-                output[footer].parts.push_back(
-                    {source_offset, bytes_per_sample});
-            }
-        }
-    }
+    return true;
+}
 
-    return output;
+ats_footer_layout
+ats_get_footer_layout(ats_footer_configuration configuration) {
+    ats_footer_layout layout;
+    char error_message[256];
+    if (!get_footer_layout(configuration, &layout,
+                           span<char>(error_message, sizeof(error_message))))
+        throw std::runtime_error(error_message);
+    return layout;
 }
 
-void parse_internal_footers(span<char> data,
-                            std::vector<data_block_location> locations,
-                            span<ats_footer_internal> destinations) {
-    if (!data.size())
-        throw std::runtime_error("Error: data buffer size is 0");
+void read_internal_footer(span<char> data, const ats_footer_layout &layout,
+                          size_t footer, ats_footer_internal *destination) {
+    char *out = reinterpret_cast<char *>(destination);
+    for_each_footer_part(layout, footer, [&](size_t offset, size_t size) {
+        assert(data.size() >= offset + size);
+        std::copy(data.data() + offset, data.data() + offset + size, out);
+        out += size;
+    });
+}
 
-    if (!data.data())
-        throw std::runtime_error("Error: NULL data buffer");
+void write_internal_footer(span<char> data, const ats_footer_layout &layout,
+                           size_t footer, const ats_footer_internal *source) {
+    const char *in = reinterpret_cast<const char *>(source);
+    for_each_footer_part(layout, footer, [&](size_t offset, size_t size) {
+        assert(data.size() >= offset + size);
+        std::copy(in, in + size, data.data() + offset);
+        in += size;
+    });
+}
 
-    if (locations.size() != destinations.size())
-        throw std::runtime_error("Error: locations and destination internal "
-                                 "footers array sizes differ");
+size_t footer_data_size(const ats_footer_layout &layout, size_t footer_count) {
+    size_t size = 0;
+    if (footer_count)
+        for_each_footer_part(layout, footer_count - 1,
+                             [&](size_t offset, size_t part_size) {
+                                 size = std::max(size, offset + part_size);
+                             });
+    return size;
+}
 
-    for (size_t i = 0; i < locations.size(); i++)
-        copy(data, locations[i], as_byte_span(&destinations[i]));
+ats_footer_internal make_internal_footer(uint8_t type,
+                                         const ats_footer_type_1 &fields) {
+    const auto analog = static_cast<uint16_t>(fields.analog_value);
+    ats_footer_internal footer;
+    footer.aux_and_pulsar_low
+        = static_cast<uint8_t>((fields.aux_in_state ? 0x01 : 0x00)
+                               | (type == 1 ? analog & 0xF0 : 0));
+    footer.pulsar_high = static_cast<uint8_t>(type == 1 ? analog >> 8 : 0);
+    footer.tt_low = static_cast<uint16_t>(fields.trigger_timestamp);
+    footer.tt_med = static_cast<uint16_t>(fields.trigger_timestamp >> 16);
+    footer.tt_high = static_cast<uint16_t>(fields.trigger_timestamp >> 32);
+    footer.rn_low = static_cast<uint16_t>(fields.record_number);
+    footer.rn_high = static_cast<uint16_t>(fields.record_number >> 16);
+    footer.fc_low = static_cast<uint16_t>(fields.frame_count);
+    footer.fc_high = static_cast<uint8_t>(fields.frame_count >> 16);
+    footer.type = type;
+    return footer;
 }
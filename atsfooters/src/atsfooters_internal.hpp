@@ -2,6 +2,7 @@
 #define ATSFOOTERS_INTERNAL_H
 
 #include <cstdint>
+#include <cstdio>
 #include <sstream>
 #include <vector>
 
@@ -20,6 +21,19 @@ struct ats_footer_internal {
     uint8_t type;
 };
 
+/// Throws if the type field of `source` is not `expected`
+void check_footer_type(const ats_footer_internal *source, uint8_t expected);
+
+/// Extracts the analog value of a type 1 footer. The type of the footer is not
+/// checked.
+int16_t parse_analog_value(const ats_footer_internal *source);
+
+/// Extracts the 48-bit trigger timestamp of a footer
+uint64_t parse_trigger_timestamp(const ats_footer_internal *source);
+
+/// Extracts the record number of a footer
+uint32_t parse_record_number(const ats_footer_internal *source);
+
 void parse_footer(const ats_footer_internal *source,
                   ats_footer_type_0 *destination);
 
@@ -27,7 +41,7 @@ void parse_footer(const ats_footer_internal *source,
                   ats_footer_type_1 *destination);
 
 /// Describes how record footer data is embdedded in DMA buffers
-enum class record_footer_embedding {
+enum class ats_footer_embedding : int {
     /// NPT footer data replaces the last samples of each record. With multiple
     /// channels active, this means that the position of NPT footer data in the
     /// buffer will vary depending on the interleaving.
@@ -47,60 +61,103 @@ enum class record_footer_embedding {
     raw_buffer,
 };
 
-record_footer_embedding get_record_footer_embedding(ats_board_type board_type,
-                                                    bool fifo);
+ats_footer_embedding get_record_footer_embedding(ats_board_type board_type,
+                                                 bool fifo);
 
 /// Record footers are encoded in a block of data which is sometimes larger than
 /// the footer itself. This function returns the size of that block, in bytes.
 size_t record_footer_block_size(ats_board_type board_type,
                                 ats_data_domain data_domain);
 
-/// Vertical resolution of digitizer models
+/// Vertical resolution of digitizer models, or 0 if the board type is not
+/// supported
 size_t resolution_bits(ats_board_type board_type);
 
 /// The number of bytes per sample that a given product normally generates. This
-/// is the board resolution padded to the next byte boundary.
+/// is the board resolution padded to the next byte boundary, or 0 if the board
+/// type is not supported.
 size_t default_bytes_per_sample(ats_board_type board_type);
 
-/// Represents the location of a contiguous block of memory in a data buffer.
-struct contiguous_data_block_location {
-    size_t offset_bytes; //< Offset of the block from the start of the buffer
-    size_t size_bytes;   //< Size of the block in bytes
-};
-
-void copy(span<const char> source, contiguous_data_block_location location,
-          span<char> destination);
-
-std::ostream &operator<<(std::ostream &os,
-                         const contiguous_data_block_location &location);
-
-/// Represents the location of a data block in a data buffer that may be split
-/// across multiple memory regions.
-struct data_block_location {
-    /// Each of the parts is a contiguous block of memory
-    std::vector<contiguous_data_block_location> parts;
-
-    /// The total size of the data block. This is the sum of `size_bytes` of all
-    /// the `parts`.
-    size_t size_bytes();
-};
-
-void copy(span<const char> source, data_block_location location,
-          span<char> destination);
-
-std::ostream &operator<<(std::ostream &os, const data_block_location &location);
-
-/// Query the location of internal record footers in buffers of data acquired
-/// using a given configuration.
-///
-/// Each of the `data_block_location`s `b` returned by this function is such
-/// that `b.size_bytes() == sizeof(ats_footer_internal)`.
-std::vector<data_block_location>
-get_internal_footer_locations(ats_footer_configuration configuration,
-                              size_t footer_count);
-
-void parse_internal_footers(span<char> data,
-                            std::vector<data_block_location> locations,
-                            span<ats_footer_internal> destination);
+/// Writes a message formatted by `snprintf()` to `error_message`, truncating
+/// it if needed. Does not allocate memory.
+template <class... Args>
+void format_error(span<char> error_message, const char *format,
+                  Args... args) {
+    if (error_message.size())
+        snprintf(error_message.data(), error_message.size(), format, args...);
+}
+
+/// Non-throwing version of `ats_get_footer_layout()`, which does not allocate
+/// memory. On failure, returns false and writes a message to `error_message`.
+bool get_footer_layout(ats_footer_configuration configuration,
+                       ats_footer_layout *layout, span<char> error_message);
+
+/// Calls `f(offset_bytes, size_bytes)` for each of the contiguous memory
+/// regions that hold the 16 bytes of footer number `footer`, in order.
+template <class F>
+void for_each_footer_part(const ats_footer_layout &layout, size_t footer,
+                          F f) {
+    const size_t r = footer % layout.records_per_buffer;
+    const size_t buf = footer / layout.records_per_buffer;
+    const size_t bytes_per_footer = sizeof(ats_footer_internal);
+    const size_t samples_per_footer
+        = bytes_per_footer / layout.bytes_per_sample;
+
+    switch (layout.embedding) {
+    case ats_footer_embedding::channel_data_shared: {
+        const size_t footer_block_size_samples_per_channel
+            = layout.footer_block_size_bytes / layout.active_channel_count
+              / layout.bytes_per_sample;
+        for (size_t c = 0; c < layout.active_channel_count; c++) {
+            for (size_t s = 0;
+                 s < samples_per_footer / layout.active_channel_count; s++) {
+                f(buf * layout.buffer_stride_bytes
+                      + r * layout.record_stride_bytes
+                      + c * layout.channel_stride_bytes
+                      + (layout.samples_per_record
+                         - footer_block_size_samples_per_channel + s)
+                            * layout.sample_stride_bytes,
+                  layout.bytes_per_sample);
+            }
+        }
+        break;
+    }
+    case ats_footer_embedding::raw_buffer:
+        f(buf * layout.buffer_stride_bytes
+              + (r + 1) * layout.record_size_bytes
+                    * layout.active_channel_count
+              - layout.footer_block_size_bytes,
+          bytes_per_footer);
+        break;
+    case ats_footer_embedding::channel_data_one_per_channel: {
+        const size_t footer_block_size_samples
+            = layout.footer_block_size_bytes / layout.bytes_per_sample;
+        for (size_t s = 0; s < samples_per_footer; s++) {
+            f(buf * layout.buffer_stride_bytes + r * layout.record_stride_bytes
+                  + (layout.samples_per_record - footer_block_size_samples + s)
+                        * layout.sample_stride_bytes,
+              layout.bytes_per_sample);
+        }
+        break;
+    }
+    }
+}
+
+/// Copies the 16 bytes of `source` to the location of footer number `footer` in
+/// `data`. This is the inverse of `read_internal_footer()`.
+void write_internal_footer(span<char> data, const ats_footer_layout &layout,
+                           size_t footer, const ats_footer_internal *source);
+
+/// Encodes footer fields in the layout generated by boards. This is the
+/// inverse of `parse_footer()`. `analog_value` is only used by type 1 footers.
+ats_footer_internal make_internal_footer(uint8_t type,
+                                         const ats_footer_type_1 &fields);
+
+/// Number of bytes of `data` that the first `footer_count` footers span
+size_t footer_data_size(const ats_footer_layout &layout, size_t footer_count);
+
+/// Copies the 16 bytes of footer number `footer` from `data` to `destination`
+void read_internal_footer(span<char> data, const ats_footer_layout &layout,
+                          size_t footer, ats_footer_internal *destination);
 
 #endif /* ATSFOOTERS_INTERNAL_H */
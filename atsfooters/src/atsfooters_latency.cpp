@@ -0,0 +1,142 @@
+#include "atsfooters_latency.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+size_t histogram_bucket(int64_t latency_ns) {
+    if (latency_ns <= 1)
+        return 0;
+    const uint64_t value = static_cast<uint64_t>(latency_ns);
+    size_t octave = 0;
+    while (value >> (octave + 1))
+        octave++;
+    const uint64_t quarter = ((value - (uint64_t(1) << octave)) << 2) >> octave;
+    return 4 * octave + static_cast<size_t>(quarter);
+}
+
+/// Midpoint of a histogram bucket, in nanoseconds
+int64_t histogram_bucket_value(size_t bucket) {
+    const double octave_start = std::ldexp(1.0, static_cast<int>(bucket / 4));
+    const double quarter = static_cast<double>(bucket % 4) + 0.5;
+    return static_cast<int64_t>(octave_start * (1.0 + quarter / 4));
+}
+
+void update_model(ats_clock_correlator *correlator, uint64_t ticks,
+                  int64_t host_ns) {
+    if (!correlator->buffer_count) {
+        correlator->reference_ticks = ticks;
+        correlator->reference_host_ns = host_ns;
+    }
+    correlator->buffer_count++;
+
+    const double x = static_cast<double>(
+        static_cast<int64_t>(ticks - correlator->reference_ticks));
+    const double y
+        = static_cast<double>(host_ns - correlator->reference_host_ns);
+    const double lambda = correlator->configuration.forgetting_factor;
+
+    // Weighted Welford update, where past buffers lose a factor `lambda` of
+    // their weight each time a buffer is added
+    correlator->weight = lambda * correlator->weight + 1;
+    const double dx = x - correlator->mean_x;
+    correlator->mean_x += dx / correlator->weight;
+    correlator->mean_y += (y - correlator->mean_y) / correlator->weight;
+    correlator->m2_x
+        = lambda * correlator->m2_x + dx * (x - correlator->mean_x);
+    correlator->co_moment_xy
+        = lambda * correlator->co_moment_xy + dx * (y - correlator->mean_y);
+
+    // Fall back to the nominal frequency until the buffers span enough time
+    // for the slope to make sense
+    const double slope = correlator->m2_x > 0
+                             ? correlator->co_moment_xy / correlator->m2_x
+                             : 0;
+    correlator->slope_ns_per_tick
+        = slope > 0 ? slope
+                    : 1e9 / correlator->configuration.ticks_per_second;
+    correlator->intercept_ns = correlator->mean_y
+                               - correlator->slope_ns_per_tick
+                                     * correlator->mean_x;
+}
+
+} // namespace
+
+int64_t ats_host_time_ns() {
+    // steady_clock is CLOCK_MONOTONIC on Linux
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+ats_clock_correlator
+ats_make_clock_correlator(ats_clock_correlator_configuration configuration) {
+    if (!(configuration.ticks_per_second > 0))
+        throw std::runtime_error(
+            "Error: clock correlator timestamp frequency must be positive");
+    if (!(configuration.forgetting_factor > 0
+          && configuration.forgetting_factor <= 1))
+        throw std::runtime_error(
+            "Error: clock correlator forgetting factor must be in (0, 1]");
+
+    ats_clock_correlator correlator = {};
+    correlator.configuration = configuration;
+    correlator.slope_ns_per_tick = 1e9 / configuration.ticks_per_second;
+    return correlator;
+}
+
+ats_buffer_latency ats_correlate_buffer(ats_clock_correlator *correlator,
+                                        span<const uint64_t> ticks,
+                                        int64_t handover_ns,
+                                        int64_t parsed_ns) {
+    if (ticks.size() == 0)
+        return ats_buffer_latency{0, 0, 0, 0};
+
+    // The buffer is handed over once its last record is acquired, so that
+    // trigger is the one closest in time to the hand-over
+    update_model(correlator, ticks[ticks.size() - 1], handover_ns);
+
+    for (const uint64_t tick : ticks) {
+        const int64_t latency
+            = parsed_ns - ats_estimate_host_time_ns(*correlator, tick);
+        correlator->latency_histogram[histogram_bucket(latency)]++;
+    }
+    correlator->latency_count += ticks.size();
+
+    // Timestamps increase, so latencies decrease along the buffer: the n-th
+    // smallest latency belongs to the n-th footer from the end.
+    const size_t n = ticks.size();
+    const auto latency_at_rank = [&](double p) {
+        const size_t rank = std::min(
+            n - 1,
+            static_cast<size_t>(std::max(0.0, std::ceil(p * double(n)) - 1)));
+        return parsed_ns
+               - ats_estimate_host_time_ns(*correlator, ticks[n - 1 - rank]);
+    };
+    return ats_buffer_latency{
+        latency_at_rank(0),
+        latency_at_rank(0.5),
+        latency_at_rank(0.99),
+        latency_at_rank(1),
+    };
+}
+
+int64_t ats_latency_percentile(const ats_clock_correlator &correlator,
+                               double p) {
+    if (!correlator.latency_count)
+        return 0;
+
+    const double target = std::min(std::max(p, 0.0), 1.0)
+                          * static_cast<double>(correlator.latency_count);
+    uint64_t cumulative = 0;
+    for (size_t bucket = 0; bucket < ats_latency_histogram_bucket_count;
+         bucket++) {
+        cumulative += correlator.latency_histogram[bucket];
+        if (cumulative && static_cast<double>(cumulative) >= target)
+            return histogram_bucket_value(bucket);
+    }
+    return histogram_bucket_value(ats_latency_histogram_bucket_count - 1);
+}
@@ -0,0 +1,325 @@
+#include "atsfooters_probe.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "atsfooters_internal.hpp"
+
+namespace {
+
+const size_t footer_size = sizeof(ats_footer_internal);
+
+/// Minimum number of consecutive footers for an alignment to be accepted
+const size_t min_chain_length = 3;
+
+/// Maximum number of candidate strides tried by the probe, by decreasing
+/// number of votes
+const size_t max_candidate_strides = 8;
+
+uint8_t type_byte(ats_footer_type footer_type) {
+    return footer_type == ats_footer_type::type_0 ? 0 : 1;
+}
+
+void load(span<char> data, size_t offset, ats_footer_internal *footer) {
+    memcpy(footer, data.data() + offset, footer_size);
+}
+
+bool fits(span<char> data, size_t offset) {
+    return offset <= data.size() && data.size() - offset >= footer_size;
+}
+
+/// True if `next` is the footer of the record right after `previous`
+bool is_successor(const ats_footer_internal &previous,
+                  const ats_footer_internal &next) {
+    return parse_record_number(&next) == parse_record_number(&previous) + 1
+           && parse_trigger_timestamp(&next)
+                  > parse_trigger_timestamp(&previous);
+}
+
+/// True if `next` is the footer of a record that comes after `previous`,
+/// possibly with records missing in between
+bool is_later(const ats_footer_internal &previous,
+              const ats_footer_internal &next) {
+    const uint32_t step
+        = parse_record_number(&next) - parse_record_number(&previous);
+    return step >= 1 && step < (uint32_t(1) << 31)
+           && parse_trigger_timestamp(&next)
+                  > parse_trigger_timestamp(&previous);
+}
+
+/// Number of consecutive footers found at `offset + k * stride`
+size_t chain_length(span<char> data, uint8_t type, size_t offset,
+                    size_t stride) {
+    if (!fits(data, offset) || data[offset + footer_size - 1] != char(type))
+        return 0;
+
+    ats_footer_internal previous, next;
+    load(data, offset, &previous);
+    size_t length = 1;
+    for (size_t p = offset + stride; fits(data, p); p += stride) {
+        if (data[p + footer_size - 1] != char(type))
+            break;
+        load(data, p, &next);
+        if (!is_successor(previous, next))
+            break;
+        previous = next;
+        length++;
+    }
+    return length;
+}
+
+/// Finds the first footer at or after `start` that is followed by its
+/// successor one stride later, and comes after `previous` if it is not NULL.
+/// Returns `data.size()` if there is none.
+size_t find_footer_pair(span<char> data, uint8_t type, size_t start,
+                        size_t stride, const ats_footer_internal *previous) {
+    if (!fits(data, stride))
+        return data.size();
+
+    const size_t last = data.size() - stride - footer_size;
+    ats_footer_internal first, second;
+    for (size_t p = start; p <= last; p++) {
+        // Jump to the next offset with the right type byte. memchr() is much
+        // faster than testing one offset at a time over long corrupted runs.
+        const void *match
+            = memchr(data.data() + p + footer_size - 1, type, last - p + 1);
+        if (!match)
+            break;
+        p = static_cast<size_t>(static_cast<const char *>(match)
+                                - data.data())
+            - (footer_size - 1);
+        if (data[p + stride + footer_size - 1] != char(type))
+            continue;
+        load(data, p, &first);
+        load(data, p + stride, &second);
+        if (is_successor(first, second)
+            && (!previous || is_later(*previous, first)))
+            return p;
+    }
+    return data.size();
+}
+
+template <class T>
+ats_footer_scan_result scan_footers(span<char> data,
+                                    ats_footer_alignment alignment,
+                                    span<T> footers, uint8_t type) {
+    if (!alignment.stride_bytes || alignment.stride_bytes < footer_size)
+        throw std::runtime_error("Error: footer stride is too small");
+
+    if (!data.data() && data.size())
+        throw std::runtime_error("Error: NULL data buffer");
+
+    ats_footer_scan_result result{0, 0, 0};
+    const size_t stride = alignment.stride_bytes;
+    size_t p = alignment.first_footer_offset_bytes;
+    bool has_previous = false;
+    size_t previous_offset = 0;
+    ats_footer_internal previous, current;
+    while (result.footers_parsed < footers.size() && fits(data, p)) {
+        bool plausible = data[p + footer_size - 1] == char(type);
+        if (plausible) {
+            load(data, p, &current);
+            if (!has_previous || !is_successor(previous, current)) {
+                // After a gap, as for the first footer, only accept a footer
+                // that is followed by its successor. Otherwise, corrupted
+                // data that looks like a later footer would break the
+                // following resync.
+                plausible = !has_previous || is_later(previous, current);
+                if (plausible && fits(data, p + stride)) {
+                    ats_footer_internal next;
+                    load(data, p + stride, &next);
+                    plausible = is_successor(current, next);
+                }
+            }
+        }
+
+        if (!plausible) {
+            // Resume the search right after the last good footer, since the
+            // corrupted region may have shifted the data in either direction
+            const size_t start
+                = has_previous ? previous_offset + footer_size : p;
+            const size_t found = find_footer_pair(
+                data, type, start, stride, has_previous ? &previous : nullptr);
+            if (found == data.size())
+                break;
+            result.resync_count++;
+            result.bytes_skipped += found > p ? found - p : p - found;
+            p = found;
+            load(data, p, &current);
+        }
+
+        parse_footer(&current, &footers[result.footers_parsed++]);
+        previous = current;
+        previous_offset = p;
+        has_previous = true;
+        p += stride;
+    }
+    return result;
+}
+
+} // namespace
+
+bool ats_probe_footer_alignment(span<char> data, ats_footer_type footer_type,
+                                ats_footer_alignment *alignment,
+                                size_t max_stride_bytes) {
+    if (!alignment)
+        throw std::runtime_error("Error: NULL footer alignment");
+
+    if (!data.data() && data.size())
+        throw std::runtime_error("Error: NULL data buffer");
+
+    const uint8_t type = type_byte(footer_type);
+    const size_t window
+        = std::min(data.size(), max_stride_bytes > data.size() / 4
+                                    ? data.size()
+                                    : 4 * max_stride_bytes + footer_size);
+    if (window < footer_size)
+        return false;
+
+    // First pass: flag the offsets where a footer of the right type could
+    // start. This is a plain byte comparison that the compiler vectorizes.
+    const size_t candidate_count = window - footer_size + 1;
+    std::vector<uint8_t> is_candidate(candidate_count);
+    const char *type_bytes = data.data() + footer_size - 1;
+    for (size_t p = 0; p < candidate_count; p++)
+        is_candidate[p] = type_bytes[p] == char(type);
+
+    // Second pass: index candidates by record number, and have each candidate
+    // vote for the distance to the candidate holding the previous record
+    std::unordered_map<uint32_t, size_t> offset_by_record_number;
+    std::unordered_map<size_t, size_t> stride_votes;
+    ats_footer_internal footer, previous;
+    for (size_t p = 0; p < candidate_count; p++) {
+        if (!is_candidate[p])
+            continue;
+        load(data, p, &footer);
+        const uint32_t record_number = parse_record_number(&footer);
+        const auto it = offset_by_record_number.find(record_number - 1);
+        if (it != offset_by_record_number.end()) {
+            const size_t stride = p - it->second;
+            load(data, it->second, &previous);
+            if (stride >= footer_size && stride <= max_stride_bytes
+                && is_successor(previous, footer))
+                stride_votes[stride]++;
+        }
+        offset_by_record_number.emplace(record_number, p);
+    }
+
+    std::vector<std::pair<size_t, size_t>> strides(stride_votes.begin(),
+                                                   stride_votes.end());
+    std::sort(strides.begin(), strides.end(),
+              [](const auto &a, const auto &b) {
+                  return a.second != b.second ? a.second > b.second
+                                              : a.first < b.first;
+              });
+    if (strides.size() > max_candidate_strides)
+        strides.resize(max_candidate_strides);
+
+    // Confirm the candidate strides, starting with the most voted, and keep
+    // the first offset that starts a long enough chain
+    for (const auto &candidate : strides) {
+        const size_t stride = candidate.first;
+        for (size_t p = 0; p < candidate_count; p++) {
+            if (!is_candidate[p])
+                continue;
+            const size_t length = chain_length(data, type, p, stride);
+            if (length >= min_chain_length) {
+                *alignment = ats_footer_alignment{p, stride, length};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool ats_get_footer_alignment(ats_footer_configuration configuration,
+                              ats_footer_alignment *alignment) {
+    if (!alignment)
+        throw std::runtime_error("Error: NULL footer alignment");
+
+    const auto layout = ats_get_footer_layout(configuration);
+
+    // All footers are made of the same parts, translated. Footers are
+    // contiguous if the parts of the first one are.
+    bool contiguous = true;
+    size_t first_offset = 0;
+    size_t end = 0;
+    bool first_part = true;
+    for_each_footer_part(layout, 0, [&](size_t offset, size_t size) {
+        if (first_part)
+            first_offset = offset;
+        else if (offset != end)
+            contiguous = false;
+        first_part = false;
+        end = offset + size;
+    });
+    if (!contiguous)
+        return false;
+
+    auto offset_of = [&](size_t footer) {
+        size_t offset = 0;
+        bool first = true;
+        for_each_footer_part(layout, footer, [&](size_t o, size_t) {
+            if (first)
+                offset = o;
+            first = false;
+        });
+        return offset;
+    };
+
+    // Offsets are linear in the record index within a buffer, and in the
+    // buffer index. The stride is constant if both slopes agree.
+    const size_t records_per_buffer = layout.records_per_buffer;
+    const size_t stride = records_per_buffer > 1
+                              ? offset_of(1) - first_offset
+                              : layout.buffer_stride_bytes;
+    if (offset_of(records_per_buffer)
+        != first_offset + records_per_buffer * stride)
+        return false;
+
+    *alignment = ats_footer_alignment{first_offset, stride, 0};
+    return true;
+}
+
+size_t ats_check_footer_configuration(span<char> data,
+                                      ats_footer_configuration configuration,
+                                      size_t footer_count) {
+    if (!data.data() && data.size())
+        throw std::runtime_error("Error: NULL data buffer");
+
+    const auto layout = ats_get_footer_layout(configuration);
+    const uint8_t type
+        = type_byte(get_ats_footer_type(configuration.board_type));
+
+    ats_footer_internal previous, current;
+    for (size_t i = 0; i < footer_count; i++) {
+        bool in_bounds = true;
+        for_each_footer_part(layout, i, [&](size_t offset, size_t size) {
+            if (offset > data.size() || data.size() - offset < size)
+                in_bounds = false;
+        });
+        if (!in_bounds)
+            return i;
+
+        read_internal_footer(data, layout, i, &current);
+        if (current.type != type || (i && !is_successor(previous, current)))
+            return i;
+        previous = current;
+    }
+    return footer_count;
+}
+
+ats_footer_scan_result ats_scan_footers(span<char> data,
+                                        ats_footer_alignment alignment,
+                                        span<ats_footer_type_0> footers) {
+    return scan_footers(data, alignment, footers, 0);
+}
+
+ats_footer_scan_result ats_scan_footers(span<char> data,
+                                        ats_footer_alignment alignment,
+                                        span<ats_footer_type_1> footers) {
+    return scan_footers(data, alignment, footers, 1);
+}
@@ -0,0 +1,305 @@
+#include "atsfooters_ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const uint64_t ring_magic = 0x474e495254415441; // "ATATRING"
+const uint32_t ring_version = 1;
+
+/// Number of 64-bit words used to store one footer in a slot
+const size_t slot_payload_words = 3;
+
+static_assert(sizeof(ats_footer_type_0) <= slot_payload_words * 8,
+              "Footer does not fit in ring slot");
+static_assert(sizeof(ats_footer_type_1) <= slot_payload_words * 8,
+              "Footer does not fit in ring slot");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Ring requires lock-free 64-bit atomics");
+
+/// Layout of the beginning of the shared-memory object. The slots follow.
+struct ring_header {
+    /// Written last by the publisher, once the rest of the header is valid
+    std::atomic<uint64_t> magic;
+    uint32_t version;
+    uint32_t footer_type;
+    uint64_t capacity;
+
+    /// Sequence number of the next footer that the publisher will write.
+    /// Every footer with a lower sequence number has been fully written.
+    alignas(64) std::atomic<uint64_t> write_sequence;
+};
+
+/// Holds one footer. `sequence` is a per-slot seqlock: it is odd while the
+/// publisher writes footer number `n` in the slot (`2n + 1`), and even once
+/// the footer is complete (`2n + 2`).
+struct ring_slot {
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> payload[slot_payload_words];
+};
+
+size_t ring_size_bytes(size_t capacity) {
+    return sizeof(ring_header) + capacity * sizeof(ring_slot);
+}
+
+[[noreturn]] void throw_system_error(const char *what, const char *name) {
+    std::ostringstream ostr;
+    ostr << "Error: " << what << " footer ring '" << name
+         << "': " << strerror(errno);
+    throw std::runtime_error(ostr.str());
+}
+
+} // namespace
+
+struct ats_footer_ring {
+    void *mapping;
+    size_t mapping_size;
+    ring_header *header;
+    ring_slot *slots;
+    uint64_t mask;
+
+    /// True for the handle returned by `ats_footer_ring_create()`, whose
+    /// mapping is writable
+    bool publisher;
+
+    /// For the publisher, the sequence number of the next footer to write. For
+    /// subscribers, the sequence number of the next footer to read.
+    uint64_t cursor;
+};
+
+ats_footer_ring *ats_footer_ring_create(const char *name,
+                                        ats_footer_type footer_type,
+                                        size_t capacity) {
+    if (!capacity || (capacity & (capacity - 1)))
+        throw std::runtime_error(
+            "Error: footer ring capacity must be a power of two");
+
+    shm_unlink(name);
+    const int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        throw_system_error("could not create", name);
+
+    const size_t size = ring_size_bytes(capacity);
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        shm_unlink(name);
+        throw_system_error("could not resize", name);
+    }
+
+    void *mapping
+        = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        shm_unlink(name);
+        throw_system_error("could not map", name);
+    }
+
+    // The object is zero-filled by ftruncate, so every slot sequence starts
+    // at 0, which matches no footer.
+    auto header = static_cast<ring_header *>(mapping);
+    header->version = ring_version;
+    header->footer_type = static_cast<uint32_t>(footer_type);
+    header->capacity = capacity;
+    header->write_sequence.store(0, std::memory_order_relaxed);
+    header->magic.store(ring_magic, std::memory_order_release);
+
+    return new ats_footer_ring{
+        mapping,
+        size,
+        header,
+        reinterpret_cast<ring_slot *>(static_cast<char *>(mapping)
+                                      + sizeof(ring_header)),
+        capacity - 1,
+        true,
+        0,
+    };
+}
+
+ats_footer_ring *ats_footer_ring_open(const char *name) {
+    const int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        throw_system_error("could not open", name);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw_system_error("could not query size of", name);
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(ring_header)) {
+        close(fd);
+        throw std::runtime_error("Error: footer ring is not initialized");
+    }
+
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        throw_system_error("could not map", name);
+
+    auto header = static_cast<ring_header *>(mapping);
+    if (header->magic.load(std::memory_order_acquire) != ring_magic
+        || header->version != ring_version
+        || size < ring_size_bytes(header->capacity)) {
+        munmap(mapping, size);
+        throw std::runtime_error(
+            "Error: shared-memory object is not a valid footer ring");
+    }
+
+    return new ats_footer_ring{
+        mapping,
+        size,
+        header,
+        reinterpret_cast<ring_slot *>(static_cast<char *>(mapping)
+                                      + sizeof(ring_header)),
+        header->capacity - 1,
+        false,
+        header->write_sequence.load(std::memory_order_acquire),
+    };
+}
+
+void ats_footer_ring_close(ats_footer_ring *ring) {
+    if (!ring)
+        return;
+    munmap(ring->mapping, ring->mapping_size);
+    delete ring;
+}
+
+void ats_footer_ring_unlink(const char *name) {
+    if (shm_unlink(name) != 0 && errno != ENOENT)
+        throw_system_error("could not unlink", name);
+}
+
+ats_footer_type ats_footer_ring_footer_type(const ats_footer_ring *ring) {
+    return static_cast<ats_footer_type>(ring->header->footer_type);
+}
+
+size_t ats_footer_ring_capacity(const ats_footer_ring *ring) {
+    return static_cast<size_t>(ring->header->capacity);
+}
+
+namespace {
+
+template <class T>
+void publish(ats_footer_ring *ring, span<const T> footers,
+             ats_footer_type footer_type) {
+    if (!ring->publisher)
+        throw std::runtime_error(
+            "Error: cannot publish to a footer ring opened as a subscriber");
+
+    if (ats_footer_ring_footer_type(ring) != footer_type)
+        throw std::runtime_error(
+            "Error: footer type does not match the footer ring");
+
+    for (const auto &footer : footers) {
+        const uint64_t n = ring->cursor++;
+        ring_slot &slot = ring->slots[n & ring->mask];
+
+        uint64_t words[slot_payload_words] = {};
+        memcpy(words, &footer, sizeof(T));
+
+        slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t w = 0; w < slot_payload_words; w++)
+            slot.payload[w].store(words[w], std::memory_order_relaxed);
+        slot.sequence.store(2 * n + 2, std::memory_order_release);
+    }
+    ring->header->write_sequence.store(ring->cursor,
+                                       std::memory_order_release);
+}
+
+template <class T>
+ats_footer_ring_read_result read(ats_footer_ring *ring, span<T> footers,
+                                 ats_footer_type footer_type) {
+    if (ring->publisher)
+        throw std::runtime_error(
+            "Error: cannot read from a footer ring created as the publisher");
+
+    if (ats_footer_ring_footer_type(ring) != footer_type)
+        throw std::runtime_error(
+            "Error: footer type does not match the footer ring");
+
+    const uint64_t capacity = ring->mask + 1;
+    ats_footer_ring_read_result result{0, 0};
+    while (result.footers_read < footers.size()) {
+        const uint64_t written
+            = ring->header->write_sequence.load(std::memory_order_acquire);
+        if (written - ring->cursor > capacity) {
+            // The publisher lapped this subscriber. Skip to the oldest footer
+            // that is still in the ring.
+            result.footers_lost += written - capacity - ring->cursor;
+            ring->cursor = written - capacity;
+        }
+        if (ring->cursor == written)
+            break;
+
+        bool overwritten = false;
+        while (ring->cursor < written
+               && result.footers_read < footers.size()) {
+            const uint64_t n = ring->cursor;
+            const ring_slot &slot = ring->slots[n & ring->mask];
+
+            uint64_t words[slot_payload_words];
+            const uint64_t before
+                = slot.sequence.load(std::memory_order_acquire);
+            for (size_t w = 0; w < slot_payload_words; w++)
+                words[w] = slot.payload[w].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t after
+                = slot.sequence.load(std::memory_order_relaxed);
+
+            if (before != 2 * n + 2 || after != before) {
+                overwritten = true;
+                break;
+            }
+            memcpy(&footers[result.footers_read], words, sizeof(T));
+            result.footers_read++;
+            ring->cursor++;
+        }
+
+        if (overwritten) {
+            // The slot was reused while being read. The publisher is at least
+            // one capacity ahead of the cursor; the next pass through the
+            // outer loop accounts for the lost footers.
+            const uint64_t now
+                = ring->header->write_sequence.load(std::memory_order_acquire);
+            if (now - ring->cursor <= capacity) {
+                result.footers_lost++;
+                ring->cursor++;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+void ats_footer_ring_publish(ats_footer_ring *ring,
+                             span<const ats_footer_type_0> footers) {
+    publish(ring, footers, ats_footer_type::type_0);
+}
+
+void ats_footer_ring_publish(ats_footer_ring *ring,
+                             span<const ats_footer_type_1> footers) {
+    publish(ring, footers, ats_footer_type::type_1);
+}
+
+ats_footer_ring_read_result
+ats_footer_ring_read(ats_footer_ring *ring, span<ats_footer_type_0> footers) {
+    return read(ring, footers, ats_footer_type::type_0);
+}
+
+ats_footer_ring_read_result
+ats_footer_ring_read(ats_footer_ring *ring, span<ats_footer_type_1> footers) {
+    return read(ring, footers, ats_footer_type::type_1);
+}
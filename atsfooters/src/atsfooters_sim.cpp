@@ -0,0 +1,260 @@
+#include "atsfooters_sim.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "atsfooters_internal.hpp"
+
+namespace {
+
+/// Trigger timestamps are 48-bit counters
+const uint64_t timestamp_mask = (uint64_t(1) << 48) - 1;
+
+/// Type byte written to corrupted footers
+const uint8_t corrupted_footer_type = 0x7F;
+
+/// xorshift64* generator, returning a number in [0, 1)
+double next_random(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return double((x * 0x2545F4914F6CDD1DULL) >> 11) / double(1ULL << 53);
+}
+
+using steady_clock = std::chrono::steady_clock;
+
+/// Buffers handed over from the board thread to the parser threads
+struct buffer_queue {
+    std::mutex mutex;
+    std::condition_variable ready;
+
+    /// Index of buffers waiting to be parsed, with the time they were handed
+    /// over
+    std::deque<std::pair<size_t, steady_clock::time_point>> pending;
+
+    /// True for buffers owned by the board, i.e. free to fill
+    std::vector<bool> free;
+
+    bool done = false;
+};
+
+void default_consumer(span<char> data, ats_footer_configuration configuration,
+                      size_t footer_count) {
+    // Scratch footers, one set per parser thread
+    static thread_local std::vector<ats_footer_type_0> footers_0;
+    static thread_local std::vector<ats_footer_type_1> footers_1;
+    if (get_ats_footer_type(configuration.board_type)
+        == ats_footer_type::type_0) {
+        footers_0.resize(footer_count);
+        ats_parse_footers(data, configuration,
+                          span(footers_0.data(), footers_0.size()));
+    } else {
+        footers_1.resize(footer_count);
+        ats_parse_footers(data, configuration,
+                          span(footers_1.data(), footers_1.size()));
+    }
+}
+
+double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty())
+        return 0;
+    const size_t index = std::min(
+        sorted.size() - 1, static_cast<size_t>(p * double(sorted.size())));
+    return sorted[index];
+}
+
+} // namespace
+
+ats_simulator_state ats_make_simulator_state(uint64_t seed) {
+    // xorshift generators must not start from 0
+    return ats_simulator_state{0, seed ? seed : 0x9E3779B97F4A7C15ULL};
+}
+
+ats_simulated_buffer_stats
+ats_fill_simulated_buffer(span<char> data,
+                          const ats_simulator_configuration &configuration,
+                          ats_simulator_state *state) {
+    if (!state)
+        throw std::runtime_error("Error: NULL simulator state");
+
+    if (configuration.drop_probability >= 1)
+        throw std::runtime_error("Error: drop probability must be below 1");
+
+    const auto layout = ats_get_footer_layout(configuration.footers);
+    if (data.size() < layout.buffer_stride_bytes)
+        throw std::runtime_error("Error: data buffer is smaller than a DMA "
+                                 "buffer");
+
+    const uint8_t type = get_ats_footer_type(configuration.footers.board_type)
+                                 == ats_footer_type::type_0
+                             ? 0
+                             : 1;
+    ats_simulated_buffer_stats stats{0, 0};
+    for (size_t r = 0; r < layout.records_per_buffer; r++) {
+        while (configuration.drop_probability > 0
+               && next_random(&state->random_state)
+                      < configuration.drop_probability) {
+            state->trigger_count++;
+            stats.records_dropped++;
+        }
+        const uint64_t trigger = state->trigger_count++;
+        const auto record_number = static_cast<uint32_t>(trigger + 1);
+        const ats_footer_type_1 fields{
+            ((trigger + 1) * configuration.ticks_per_trigger) & timestamp_mask,
+            record_number,
+            configuration.records_per_frame
+                ? static_cast<uint32_t>(trigger
+                                        / configuration.records_per_frame)
+                : 0,
+            (trigger & 1) != 0,
+            static_cast<int16_t>((trigger * 16) & 0xFFF0),
+        };
+        auto footer = make_internal_footer(type, fields);
+        if (configuration.corrupt_probability > 0
+            && next_random(&state->random_state)
+                   < configuration.corrupt_probability) {
+            footer.type = corrupted_footer_type;
+            stats.footers_corrupted++;
+        }
+        write_internal_footer(data, layout, r, &footer);
+    }
+    return stats;
+}
+
+ats_simulation_report
+ats_run_simulation(const ats_simulator_configuration &configuration,
+                   std::function<void(span<char>)> consumer) {
+    if (!(configuration.trigger_rate > 0))
+        throw std::runtime_error("Error: trigger rate must be positive");
+
+    if (!configuration.buffer_count)
+        throw std::runtime_error("Error: buffer count is 0");
+
+    if (!configuration.parser_thread_count)
+        throw std::runtime_error("Error: parser thread count is 0");
+
+    const auto layout = ats_get_footer_layout(configuration.footers);
+    const size_t buffer_size = layout.buffer_stride_bytes;
+    if (!consumer) {
+        consumer = [&](span<char> data) {
+            default_consumer(data, configuration.footers,
+                             layout.records_per_buffer);
+        };
+    }
+
+    // Mid-scale samples for all buffers
+    std::vector<char> memory(buffer_size * configuration.buffer_count,
+                             char(0x80));
+    buffer_queue queue;
+    queue.free.assign(configuration.buffer_count, true);
+
+    ats_simulation_report report{};
+    std::mutex report_mutex;
+    std::vector<double> latencies;
+    latencies.reserve(configuration.buffers_per_acquisition);
+
+    auto parser = [&]() {
+        for (;;) {
+            std::pair<size_t, steady_clock::time_point> item;
+            {
+                std::unique_lock<std::mutex> lock(queue.mutex);
+                queue.ready.wait(lock, [&] {
+                    return !queue.pending.empty() || queue.done;
+                });
+                if (queue.pending.empty())
+                    return;
+                item = queue.pending.front();
+                queue.pending.pop_front();
+            }
+
+            bool failed = false;
+            try {
+                consumer(span<char>(memory.data() + item.first * buffer_size,
+                                    buffer_size));
+            } catch (const std::exception &) {
+                failed = true;
+            }
+            const std::chrono::duration<double> elapsed
+                = steady_clock::now() - item.second;
+            const double latency = elapsed.count();
+
+            {
+                std::lock_guard<std::mutex> lock(report_mutex);
+                latencies.push_back(latency);
+                if (failed)
+                    report.parse_errors++;
+            }
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.free[item.first] = true;
+        }
+    };
+
+    std::vector<std::thread> parsers;
+    for (size_t i = 0; i < configuration.parser_thread_count; i++)
+        parsers.emplace_back(parser);
+
+    // The board thread is the calling thread. Buffer `b` is complete once the
+    // triggers of its records have all arrived.
+    auto state = ats_make_simulator_state(configuration.seed);
+    const auto buffer_period = std::chrono::duration<double>(
+        double(layout.records_per_buffer) / configuration.trigger_rate);
+    const auto start = steady_clock::now();
+    size_t next_buffer = 0;
+    for (size_t b = 0; b < configuration.buffers_per_acquisition; b++) {
+        std::this_thread::sleep_until(
+            start + std::chrono::duration_cast<steady_clock::duration>(
+                        buffer_period * double(b + 1)));
+
+        bool available;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            available = queue.free[next_buffer];
+            if (available)
+                queue.free[next_buffer] = false;
+        }
+        if (!available) {
+            // The board has nowhere to write: the records of this buffer are
+            // lost, but triggers keep coming
+            report.buffer_overruns++;
+            state.trigger_count += layout.records_per_buffer;
+            continue;
+        }
+
+        const auto stats = ats_fill_simulated_buffer(
+            span<char>(memory.data() + next_buffer * buffer_size, buffer_size),
+            configuration, &state);
+        report.records_dropped += stats.records_dropped;
+        report.footers_corrupted += stats.footers_corrupted;
+        report.buffers_acquired++;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.pending.emplace_back(next_buffer, steady_clock::now());
+        }
+        queue.ready.notify_one();
+        next_buffer = (next_buffer + 1) % configuration.buffer_count;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.done = true;
+    }
+    queue.ready.notify_all();
+    for (auto &thread : parsers)
+        thread.join();
+
+    report.elapsed_seconds
+        = std::chrono::duration<double>(steady_clock::now() - start).count();
+    std::sort(latencies.begin(), latencies.end());
+    report.latency_p50_seconds = percentile(latencies, 0.5);
+    report.latency_p99_seconds = percentile(latencies, 0.99);
+    report.latency_max_seconds = latencies.empty() ? 0 : latencies.back();
+    return report;
+}
@@ -0,0 +1,308 @@
+#include "atsfooters_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "atsfooters_internal.hpp"
+
+namespace {
+
+/// Trigger timestamps are 48-bit counters
+const uint64_t timestamp_mask = (uint64_t(1) << 48) - 1;
+
+void add_to_rate_window(ats_rate_window *window, uint64_t timestamp) {
+    const uint64_t slot = timestamp / window->slot_width_ticks;
+    if (slot > window->latest_slot) {
+        const uint64_t gap = slot - window->latest_slot;
+        if (gap >= ats_rate_window_slot_count) {
+            std::fill(std::begin(window->record_counts),
+                      std::end(window->record_counts), 0);
+        } else {
+            for (uint64_t s = window->latest_slot + 1; s <= slot; s++)
+                window->record_counts[s % ats_rate_window_slot_count] = 0;
+        }
+        window->latest_slot = slot;
+    } else if (window->latest_slot - slot >= ats_rate_window_slot_count) {
+        // Older than the window
+        return;
+    }
+    window->record_counts[slot % ats_rate_window_slot_count]++;
+}
+
+void add_footer(ats_trigger_statistics *stats, uint64_t raw_timestamp,
+                uint32_t record_number) {
+    if (!stats->record_count) {
+        stats->first_timestamp = raw_timestamp;
+        stats->last_timestamp = raw_timestamp;
+        for (auto &window : stats->rate_windows)
+            window.latest_slot = raw_timestamp / window.slot_width_ticks;
+    } else {
+        const uint64_t interval
+            = (raw_timestamp - stats->last_raw_timestamp) & timestamp_mask;
+        stats->last_timestamp += interval;
+
+        // Record numbers only move forward. Anything else is a reset or a
+        // reordering, which is not counted as missed records.
+        const uint32_t step = record_number - stats->last_record_number;
+        const bool contiguous = step == 1;
+        if (step > 1 && step < (uint32_t(1) << 31))
+            stats->missed_record_count += step - 1;
+
+        if (contiguous) {
+            stats->interval_count++;
+            stats->interval_min = std::min(stats->interval_min, interval);
+            stats->interval_max = std::max(stats->interval_max, interval);
+            const double delta = double(interval) - stats->interval_mean;
+            stats->interval_mean += delta / double(stats->interval_count);
+            stats->interval_m2
+                += delta * (double(interval) - stats->interval_mean);
+
+            const auto &config = stats->configuration;
+            if (interval < config.histogram_min_interval_ticks) {
+                stats->histogram_underflow++;
+            } else {
+                const uint64_t bucket
+                    = (interval - config.histogram_min_interval_ticks)
+                      / config.histogram_bucket_width_ticks;
+                if (bucket < ats_trigger_histogram_bucket_count)
+                    stats->histogram[bucket]++;
+                else
+                    stats->histogram_overflow++;
+            }
+        }
+    }
+
+    stats->last_raw_timestamp = raw_timestamp;
+    stats->last_record_number = record_number;
+    stats->record_count++;
+    for (auto &window : stats->rate_windows)
+        add_to_rate_window(&window, stats->last_timestamp);
+}
+
+template <class T>
+void update(ats_trigger_statistics *statistics, span<const T> footers) {
+    if (!statistics)
+        throw std::runtime_error("Error: NULL trigger statistics");
+    for (const auto &footer : footers)
+        add_footer(statistics, footer.trigger_timestamp, footer.record_number);
+}
+
+/// Moves the unwrapped timestamps of `stats` `offset` ticks later.
+/// `offset` is a multiple of 2^48, and thus of the slot width of rate windows.
+void rebase(ats_trigger_statistics *stats, uint64_t offset) {
+    stats->first_timestamp += offset;
+    stats->last_timestamp += offset;
+    for (auto &window : stats->rate_windows) {
+        const uint64_t slots = offset / window.slot_width_ticks;
+        window.latest_slot += slots;
+        std::rotate(std::begin(window.record_counts),
+                    std::end(window.record_counts)
+                        - slots % ats_rate_window_slot_count,
+                    std::end(window.record_counts));
+    }
+}
+
+void merge_rate_windows(ats_rate_window *destination,
+                        const ats_rate_window &source) {
+    const uint64_t latest
+        = std::max(destination->latest_slot, source.latest_slot);
+    uint64_t counts[ats_rate_window_slot_count] = {};
+    const ats_rate_window *windows[] = {destination, &source};
+    for (const auto *window : windows) {
+        for (uint64_t age = 0;
+             age < ats_rate_window_slot_count && age <= window->latest_slot;
+             age++) {
+            const uint64_t slot = window->latest_slot - age;
+            if (latest - slot >= ats_rate_window_slot_count)
+                break;
+            counts[slot % ats_rate_window_slot_count]
+                += window->record_counts[slot % ats_rate_window_slot_count];
+        }
+    }
+    destination->latest_slot = latest;
+    std::copy(std::begin(counts), std::end(counts),
+              std::begin(destination->record_counts));
+}
+
+} // namespace
+
+ats_trigger_statistics ats_make_trigger_statistics(
+    ats_trigger_statistics_configuration configuration) {
+    if (!(configuration.ticks_per_second > 0))
+        throw std::runtime_error("Error: ticks per second must be positive");
+
+    if (!configuration.histogram_bucket_width_ticks)
+        throw std::runtime_error("Error: histogram bucket width is 0");
+
+    ats_trigger_statistics stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.configuration = configuration;
+    stats.interval_min = UINT64_MAX;
+    for (size_t w = 0; w < ats_rate_window_count; w++) {
+        if (!configuration.rate_window_ticks[w])
+            throw std::runtime_error("Error: rate window length is 0");
+        // Round slot widths down to a power of two, so that they divide the
+        // 2^48-tick period of timestamps
+        const uint64_t slot_width
+            = configuration.rate_window_ticks[w] / ats_rate_window_slot_count;
+        uint64_t power = 1;
+        while (power <= slot_width / 2)
+            power *= 2;
+        stats.rate_windows[w].slot_width_ticks = power;
+    }
+    return stats;
+}
+
+void ats_update_trigger_statistics(ats_trigger_statistics *statistics,
+                                   span<const ats_footer_type_0> footers) {
+    update(statistics, footers);
+}
+
+void ats_update_trigger_statistics(ats_trigger_statistics *statistics,
+                                   span<const ats_footer_type_1> footers) {
+    update(statistics, footers);
+}
+
+void ats_accumulate_trigger_statistics(span<char> data,
+                                       ats_footer_configuration configuration,
+                                       size_t footer_count,
+                                       ats_trigger_statistics *statistics) {
+    if (!statistics)
+        throw std::runtime_error("Error: NULL trigger statistics");
+
+    if (!footer_count)
+        return;
+
+    if (!data.size())
+        throw std::runtime_error("Error: data buffer size is 0");
+
+    if (!data.data())
+        throw std::runtime_error("Error: NULL data buffer");
+
+    const uint8_t type
+        = get_ats_footer_type(configuration.board_type)
+                  == ats_footer_type::type_0
+              ? 0
+              : 1;
+    const auto layout = ats_get_footer_layout(configuration);
+    ats_footer_internal internal;
+    for (size_t i = 0; i < footer_count; i++) {
+        read_internal_footer(data, layout, i, &internal);
+        check_footer_type(&internal, type);
+        add_footer(statistics, parse_trigger_timestamp(&internal),
+                   parse_record_number(&internal));
+    }
+}
+
+void ats_merge_trigger_statistics(ats_trigger_statistics *destination,
+                                  const ats_trigger_statistics &source) {
+    if (!destination)
+        throw std::runtime_error("Error: NULL trigger statistics");
+
+    if (memcmp(&destination->configuration, &source.configuration,
+               sizeof(ats_trigger_statistics_configuration))
+        != 0)
+        throw std::runtime_error(
+            "Error: cannot merge trigger statistics with different "
+            "configurations");
+
+    if (!source.record_count)
+        return;
+
+    if (!destination->record_count) {
+        *destination = source;
+        return;
+    }
+
+    // Each accumulator unwraps timestamps from the raw value of its first
+    // footer, so their time bases differ by a multiple of 2^48 ticks. The
+    // first footers of both accumulators are assumed to be less than 2^47
+    // ticks apart. Move the accumulator whose base is earlier to the base of
+    // the other one.
+    ats_trigger_statistics &dest = *destination;
+    ats_trigger_statistics other = source;
+    const uint64_t distance
+        = (other.first_timestamp - dest.first_timestamp) & timestamp_mask;
+    const int64_t signed_distance
+        = distance < (uint64_t(1) << 47)
+              ? int64_t(distance)
+              : int64_t(distance) - int64_t(timestamp_mask + 1);
+    const int64_t shift = int64_t(dest.first_timestamp) + signed_distance
+                          - int64_t(other.first_timestamp);
+    if (shift >= 0)
+        rebase(&other, uint64_t(shift));
+    else
+        rebase(&dest, uint64_t(-shift));
+
+    if (other.last_timestamp > dest.last_timestamp) {
+        dest.last_timestamp = other.last_timestamp;
+        dest.last_raw_timestamp = other.last_raw_timestamp;
+        dest.last_record_number = other.last_record_number;
+    }
+    dest.first_timestamp
+        = std::min(dest.first_timestamp, other.first_timestamp);
+    dest.record_count += other.record_count;
+    dest.missed_record_count += other.missed_record_count;
+
+    // Chan et al.'s method to combine the means and variances of two samples
+    const uint64_t count = dest.interval_count + other.interval_count;
+    if (count) {
+        const double delta = other.interval_mean - dest.interval_mean;
+        const double source_weight
+            = double(other.interval_count) / double(count);
+        dest.interval_mean += delta * source_weight;
+        dest.interval_m2 += other.interval_m2
+                            + delta * delta * double(dest.interval_count)
+                                  * source_weight;
+    }
+    dest.interval_count = count;
+    dest.interval_min = std::min(dest.interval_min, other.interval_min);
+    dest.interval_max = std::max(dest.interval_max, other.interval_max);
+
+    for (size_t b = 0; b < ats_trigger_histogram_bucket_count; b++)
+        dest.histogram[b] += other.histogram[b];
+    dest.histogram_underflow += other.histogram_underflow;
+    dest.histogram_overflow += other.histogram_overflow;
+
+    for (size_t w = 0; w < ats_rate_window_count; w++)
+        merge_rate_windows(&dest.rate_windows[w], other.rate_windows[w]);
+}
+
+double ats_trigger_interval_variance(const ats_trigger_statistics &statistics) {
+    if (statistics.interval_count < 2)
+        return 0;
+    return statistics.interval_m2 / double(statistics.interval_count - 1);
+}
+
+double ats_records_per_second(const ats_trigger_statistics &statistics,
+                              size_t window) {
+    if (window >= ats_rate_window_count)
+        throw std::runtime_error("Error: invalid rate window");
+
+    const ats_rate_window &w = statistics.rate_windows[window];
+    uint64_t records = 0;
+    for (auto count : w.record_counts)
+        records += count;
+    if (records < 2)
+        return 0;
+
+    // When the window reaches back to the first footer, the records span
+    // `records - 1` trigger intervals. Otherwise, the window starts at an
+    // arbitrary point between two triggers.
+    const uint64_t oldest_slot
+        = w.latest_slot >= ats_rate_window_slot_count - 1
+              ? w.latest_slot - (ats_rate_window_slot_count - 1)
+              : 0;
+    const uint64_t window_start = oldest_slot * w.slot_width_ticks;
+    uint64_t start = window_start;
+    if (statistics.first_timestamp >= window_start) {
+        start = statistics.first_timestamp;
+        records--;
+    }
+    if (statistics.last_timestamp <= start)
+        return 0;
+    return double(records) * statistics.configuration.ticks_per_second
+           / double(statistics.last_timestamp - start);
+}
@@ -0,0 +1,165 @@
+#include "atsfooters_time.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+/// Trigger timestamps are 48-bit counters
+const uint64_t timestamp_period = uint64_t(1) << 48;
+
+/// Same as `static_cast<double>(value)`. SSE2 has no packed conversion from
+/// 64-bit integers, so the conversion is done with floating-point arithmetic on
+/// the two 32-bit halves of `value`, which compilers can vectorize in optimized
+/// builds (e.g. GCC at -O3, or -O2 from GCC 12; Clang at -O2).
+inline double to_double(uint64_t value) {
+    const uint64_t low_bits = (value & 0xFFFFFFFF) | 0x4330000000000000;
+    const uint64_t high_bits = (value >> 32) | 0x4530000000000000;
+    double low, high;
+    memcpy(&low, &low_bits, sizeof(double));   // 2^52 + low half
+    memcpy(&high, &high_bits, sizeof(double)); // 2^84 + high half * 2^32
+    return (high - 19342813118337666422669312.) + low; // 2^84 + 2^52
+}
+
+/// Rounds `value`, which must be in [0, 2^51), to the nearest integer, ties
+/// to even like `std::nearbyint()` in the default rounding mode. Same
+/// vectorization rationale as `to_double()`.
+inline int64_t round_to_int64(double value) {
+    const double shifted = value + 4503599627370496.; // 2^52
+    int64_t bits;
+    memcpy(&bits, &shifted, sizeof(double));
+    return bits - 0x4330000000000000;
+}
+
+/// Unwraps the raw timestamps already copied to `ticks`, in place.
+///
+/// Wraparounds are rare, so the loops are split in a way that lets the
+/// compiler vectorize them: one pass counts wraparounds, and if there are none,
+/// a second pass adds a constant offset. The sequential loop only runs on
+/// buffers where the counter wraps.
+void unwrap_in_place(span<uint64_t> ticks, ats_timestamp_unwrap_state *state) {
+    ats_timestamp_unwrap_state local_state{0, 0};
+    if (!state)
+        state = &local_state;
+
+    const size_t count = ticks.size();
+    if (!count)
+        return;
+
+    uint64_t *t = ticks.data();
+    // Timestamps are lower than 2^48, so the difference between two of them
+    // is negative, i.e. has its top bit set, if and only if the counter wrapped
+    size_t wraps = t[0] < state->last_raw_timestamp;
+    for (size_t i = 1; i < count; i++)
+        wraps += (t[i] - t[i - 1]) >> 63;
+
+    const uint64_t last_raw_timestamp = t[count - 1];
+    uint64_t offset = state->offset_ticks;
+    if (!wraps) {
+        for (size_t i = 0; i < count; i++)
+            t[i] += offset;
+    } else {
+        uint64_t previous = state->last_raw_timestamp;
+        for (size_t i = 0; i < count; i++) {
+            const uint64_t raw = t[i];
+            if (raw < previous)
+                offset += timestamp_period;
+            previous = raw;
+            t[i] = raw + offset;
+        }
+    }
+
+    state->offset_ticks = offset;
+    state->last_raw_timestamp = last_raw_timestamp;
+}
+
+template <class T>
+void unwrap(span<const T> footers, span<uint64_t> ticks,
+            ats_timestamp_unwrap_state *state) {
+    if (ticks.size() < footers.size())
+        throw std::runtime_error("Error: tick array is too small");
+
+    const T *f = footers.data();
+    uint64_t *t = ticks.data();
+    for (size_t i = 0; i < footers.size(); i++)
+        t[i] = f[i].trigger_timestamp;
+    unwrap_in_place(span<uint64_t>(t, footers.size()), state);
+}
+
+double seconds_per_tick(double sample_rate, uint32_t timestamp_divisor) {
+    if (!(sample_rate > 0))
+        throw std::runtime_error("Error: sample rate must be positive");
+
+    if (!timestamp_divisor)
+        throw std::runtime_error("Error: timestamp divisor is 0");
+
+    return timestamp_divisor / sample_rate;
+}
+
+} // namespace
+
+void ats_unwrap_timestamps(span<const ats_footer_type_0> footers,
+                           span<uint64_t> ticks,
+                           ats_timestamp_unwrap_state *state) {
+    unwrap(footers, ticks, state);
+}
+
+void ats_unwrap_timestamps(span<const ats_footer_type_1> footers,
+                           span<uint64_t> ticks,
+                           ats_timestamp_unwrap_state *state) {
+    unwrap(footers, ticks, state);
+}
+
+void ats_unwrap_timestamps(span<const uint64_t> raw_timestamps,
+                           span<uint64_t> ticks,
+                           ats_timestamp_unwrap_state *state) {
+    if (ticks.size() < raw_timestamps.size())
+        throw std::runtime_error("Error: tick array is too small");
+
+    const uint64_t *raw = raw_timestamps.data();
+    uint64_t *t = ticks.data();
+    for (size_t i = 0; i < raw_timestamps.size(); i++)
+        t[i] = raw[i];
+    unwrap_in_place(span<uint64_t>(t, raw_timestamps.size()), state);
+}
+
+void ats_ticks_to_seconds(span<const uint64_t> ticks, double sample_rate,
+                          uint32_t timestamp_divisor, span<double> seconds) {
+    if (seconds.size() < ticks.size())
+        throw std::runtime_error("Error: output array is too small");
+
+    const double scale = seconds_per_tick(sample_rate, timestamp_divisor);
+    const uint64_t *t = ticks.data();
+    double *s = seconds.data();
+    for (size_t i = 0; i < ticks.size(); i++)
+        s[i] = to_double(t[i]) * scale;
+}
+
+void ats_ticks_to_nanoseconds(span<const uint64_t> ticks, double sample_rate,
+                              uint32_t timestamp_divisor,
+                              span<int64_t> nanoseconds) {
+    if (nanoseconds.size() < ticks.size())
+        throw std::runtime_error("Error: output array is too small");
+
+    const double scale = seconds_per_tick(sample_rate, timestamp_divisor) * 1e9;
+    const uint64_t *t = ticks.data();
+    int64_t *ns = nanoseconds.data();
+    // The fast rounding only applies to results lower than 2^51. The bitwise OR
+    // of all tick counts bounds the largest one.
+    uint64_t bound = 0;
+    for (size_t i = 0; i < ticks.size(); i++)
+        bound |= t[i];
+    if (to_double(bound) * scale < 2251799813685248.) { // 2^51
+        for (size_t i = 0; i < ticks.size(); i++)
+            ns[i] = round_to_int64(to_double(t[i]) * scale);
+    } else {
+        // Same rounding as the fast path, saturated to the range of int64_t
+        for (size_t i = 0; i < ticks.size(); i++) {
+            const double value = std::nearbyint(to_double(t[i]) * scale);
+            ns[i] = value < 9223372036854775808. // 2^63
+                        ? static_cast<int64_t>(value)
+                        : INT64_MAX;
+        }
+    }
+}
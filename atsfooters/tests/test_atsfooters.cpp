@@ -1,14 +1,53 @@
 #include "atsfooters.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory_resource>
+#include <new>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
+#include "atsfooters_arrow.hpp"
+#include "atsfooters_frames.hpp"
+#include "atsfooters_internal.hpp"
+#include "atsfooters_latency.hpp"
+#include "atsfooters_probe.hpp"
+#include "atsfooters_sim.hpp"
+#include "atsfooters_stats.hpp"
+#include "atsfooters_time.hpp"
 #include "utils.hpp"
 
+#ifdef ATS_HAVE_RING
+#    include <unistd.h>
+
+#    include "atsfooters_ring.hpp"
+#endif
+
+/// Number of calls to the global `operator new`, to check that some code
+/// paths never allocate memory. Only allocations made by the library itself
+/// are counted on platforms where the library shares the operators of the
+/// executable.
+static std::atomic<size_t> allocation_count{0};
+
+void *operator new(size_t size) {
+    allocation_count++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
 void check_record_numbers(std::vector<uint32_t> rec_nums) {
     for (size_t i = 0; i < rec_nums.size(); i++) {
         const size_t actual = rec_nums[i];
@@ -92,6 +131,485 @@ std::vector<uint64_t> trigger_timestamps(span<ats_footer_type_1> footers) {
     return out;
 }
 
+void check_analog_values(span<char> data, ats_footer_configuration config,
+                         span<ats_footer_type_1> footers) {
+    std::vector<int16_t> values(footers.size());
+    ats_parse_analog_values(data, config, footers.size(),
+                            span(values.data(), values.size()));
+    for (size_t i = 0; i < footers.size(); i++) {
+        if (values[i] != footers[i].analog_value) {
+            std::ostringstream ostr;
+            ostr << "Error: analog value " << i << " is " << values[i]
+                 << " instead of " << footers[i].analog_value;
+            throw std::runtime_error(ostr.str());
+        }
+    }
+
+    const size_t decimation_factor = 3;
+    const size_t decimated_count
+        = (footers.size() + decimation_factor - 1) / decimation_factor;
+    std::vector<int16_t> mins(decimated_count);
+    std::vector<float> maxs(decimated_count);
+    if (ats_parse_analog_values(data, config, footers.size(),
+                                span(mins.data(), mins.size()),
+                                decimation_factor, ats_analog_reduction::min)
+        != decimated_count)
+        throw std::runtime_error("Error: unexpected decimated value count");
+    ats_parse_analog_values(data, config, footers.size(),
+                            span(maxs.data(), maxs.size()), 2.f,
+                            decimation_factor, ats_analog_reduction::max);
+    for (size_t v = 0; v < decimated_count; v++) {
+        int16_t min = INT16_MAX;
+        int16_t max = INT16_MIN;
+        for (size_t i = v * decimation_factor;
+             i < std::min(footers.size(), (v + 1) * decimation_factor); i++) {
+            min = std::min(min, footers[i].analog_value);
+            max = std::max(max, footers[i].analog_value);
+        }
+        if (mins[v] != min || maxs[v] != 2.f * max) {
+            std::ostringstream ostr;
+            ostr << "Error: decimated analog values " << v << " are "
+                 << mins[v] << "/" << maxs[v] << " instead of " << min << "/"
+                 << 2 * max;
+            throw std::runtime_error(ostr.str());
+        }
+    }
+}
+
+void check_analog_mean() {
+    std::cout << "Checking analog value mean reduction\n";
+
+    // Footers only keep the 12 most significant bits of analog values
+    const int16_t analog_values[] = {16, 32, 32, -160, -320, 1600};
+    const size_t footer_count = 6;
+    const ats_footer_configuration config{
+        ats_board_type::ats9352,
+        ats_data_domain::time,
+        1,
+        ats_data_layout::record_interleaved,
+        2048 * 2,
+        footer_count,
+        false};
+    const auto layout = ats_get_footer_layout(config);
+    std::vector<char> contents(layout.buffer_stride_bytes);
+    const span<char> data(contents.data(), contents.size());
+    for (size_t i = 0; i < footer_count; i++) {
+        const auto footer = make_internal_footer(
+            1, ats_footer_type_1{0, static_cast<uint32_t>(i + 1), 0, false,
+                                 analog_values[i]});
+        write_internal_footer(data, layout, i, &footer);
+    }
+
+    int16_t means[2];
+    float scaled_means[2];
+    ats_parse_analog_values(data, config, footer_count, span(means, 2), 3,
+                            ats_analog_reduction::mean);
+    ats_parse_analog_values(data, config, footer_count, span(scaled_means, 2),
+                            0.5f, 3, ats_analog_reduction::mean);
+
+    // (16 + 32 + 32) / 3 = 26.67 and (-160 - 320 + 1600) / 3 = 373.33
+    if (means[0] != 27 || means[1] != 373
+        || std::abs(scaled_means[0] - 40.f / 3) > 1e-4f
+        || std::abs(scaled_means[1] - 560.f / 3) > 1e-3f)
+        throw std::runtime_error("Error: unexpected mean analog values");
+
+    // Data that does not hold all the footers is rejected
+    bool rejected = false;
+    try {
+        ats_parse_analog_values(span(contents.data(), contents.size() - 1),
+                                config, footer_count, span(means, 2), 3,
+                                ats_analog_reduction::mean);
+    } catch (const std::runtime_error &) {
+        rejected = true;
+    }
+    if (!rejected)
+        throw std::runtime_error("Error: short analog value data accepted");
+}
+
+template <class T>
+void check_trigger_statistics(span<char> data, ats_footer_configuration config,
+                              span<T> footers,
+                              uint64_t expected_ticks_per_trigger) {
+    const ats_trigger_statistics_configuration stats_config{
+        1e9,
+        expected_ticks_per_trigger / 2,
+        expected_ticks_per_trigger / 32,
+        {expected_ticks_per_trigger * 4, expected_ticks_per_trigger * 16,
+         expected_ticks_per_trigger * 64},
+    };
+
+    auto stats = ats_make_trigger_statistics(stats_config);
+    ats_accumulate_trigger_statistics(data, config, footers.size(), &stats);
+    const double tolerance = expected_ticks_per_trigger / 20.; // 5% tolerance
+    if (stats.record_count != footers.size() || stats.missed_record_count
+        || stats.interval_count != footers.size() - 1
+        || std::abs(stats.interval_mean - expected_ticks_per_trigger)
+               > tolerance) {
+        std::ostringstream ostr;
+        ostr << "Error: trigger statistics mismatch. Records: "
+             << stats.record_count << ", missed: " << stats.missed_record_count
+             << ", mean interval: " << stats.interval_mean;
+        throw std::runtime_error(ostr.str());
+    }
+
+    // Merging the statistics of two halves gives the same result, except for
+    // the interval between the halves
+    const size_t half = footers.size() / 2;
+    auto first = ats_make_trigger_statistics(stats_config);
+    auto second = ats_make_trigger_statistics(stats_config);
+    ats_update_trigger_statistics(&first,
+                                  span<const T>(footers.data(), half));
+    ats_update_trigger_statistics(
+        &second,
+        span<const T>(footers.data() + half, footers.size() - half));
+    ats_merge_trigger_statistics(&first, second);
+    uint64_t histogram_count
+        = first.histogram_underflow + first.histogram_overflow;
+    for (auto count : first.histogram)
+        histogram_count += count;
+    if (first.record_count != stats.record_count
+        || first.interval_count != stats.interval_count - 1
+        || histogram_count != first.interval_count
+        || first.last_timestamp != stats.last_timestamp
+        || std::abs(first.interval_mean - stats.interval_mean) > tolerance
+        || std::abs(ats_records_per_second(first, 2)
+                    - ats_records_per_second(stats, 2))
+               > ats_records_per_second(stats, 2) / 20)
+        throw std::runtime_error("Error: merged trigger statistics mismatch");
+}
+
+void check_missed_records() {
+    std::cout << "Checking missed record detection\n";
+    std::vector<ats_footer_type_0> footers{
+        {100, 1, 0, false},
+        {200, 2, 0, false},
+        {500, 5, 0, false},
+        {600, 6, 0, false},
+    };
+    auto stats = ats_make_trigger_statistics({1e6, 0, 10, {400, 400, 400}});
+    ats_update_trigger_statistics(
+        &stats, span<const ats_footer_type_0>(footers.data(), footers.size()));
+    if (stats.missed_record_count != 2 || stats.interval_count != 2
+        || stats.interval_min != 100 || stats.interval_max != 100
+        || stats.histogram[10] != 2)
+        throw std::runtime_error("Error: missed records not detected");
+}
+
+void check_statistics_merge_across_wrap() {
+    std::cout << "Checking trigger statistics merge across a timestamp wrap\n";
+    // Timestamps wrap around between the two halves
+    std::vector<ats_footer_type_0> footers;
+    for (uint32_t i = 0; i < 64; i++)
+        footers.push_back({((uint64_t(1) << 48) - 32 * 1000 + i * 1000)
+                               & ((uint64_t(1) << 48) - 1),
+                           i + 1, 0, false});
+    const ats_trigger_statistics_configuration config{
+        1e6, 0, 100, {8000, 16000, 64000}};
+    const auto half = span<const ats_footer_type_0>(footers.data(), 32);
+    const auto second_half
+        = span<const ats_footer_type_0>(footers.data() + 32, 32);
+
+    auto all = ats_make_trigger_statistics(config);
+    ats_update_trigger_statistics(
+        &all, span<const ats_footer_type_0>(footers.data(), footers.size()));
+
+    // Merging in either order gives the statistics of all footers
+    for (const bool reverse : {false, true}) {
+        auto first = ats_make_trigger_statistics(config);
+        auto second = ats_make_trigger_statistics(config);
+        ats_update_trigger_statistics(&first, half);
+        ats_update_trigger_statistics(&second, second_half);
+        if (reverse)
+            std::swap(first, second);
+        ats_merge_trigger_statistics(&first, second);
+
+        bool same_windows = true;
+        for (size_t w = 0; w < ats_rate_window_count; w++)
+            same_windows
+                = same_windows
+                  && first.rate_windows[w].latest_slot
+                         == all.rate_windows[w].latest_slot
+                  && std::equal(std::begin(first.rate_windows[w].record_counts),
+                                std::end(first.rate_windows[w].record_counts),
+                                std::begin(all.rate_windows[w].record_counts));
+        if (first.first_timestamp != all.first_timestamp
+            || first.last_timestamp != all.last_timestamp
+            || first.last_record_number != all.last_record_number
+            || first.record_count != all.record_count
+            || first.interval_count != all.interval_count - 1
+            || first.interval_min != 1000 || first.interval_max != 1000
+            || !same_windows
+            || ats_records_per_second(first, 2)
+                   != ats_records_per_second(all, 2))
+            throw std::runtime_error(
+                "Error: trigger statistics merged across a wrap mismatch");
+    }
+}
+
+template <class T>
+void check_footer_view(span<char> data, ats_footer_configuration config,
+                       span<T> footers) {
+    using iterator = typename ats_footer_view<T>::iterator;
+    static_assert(
+        std::is_same<typename std::iterator_traits<iterator>::iterator_category,
+                     std::random_access_iterator_tag>::value,
+        "Footer view iterators must be random-access iterators");
+
+    const ats_footer_view<T> view(data, config);
+    if (view.size() != footers.size())
+        throw std::runtime_error("Error: footer view has the wrong size");
+    for (size_t i = 0; i < footers.size(); i++) {
+        const T footer = view[i];
+        if (footer.trigger_timestamp != footers[i].trigger_timestamp
+            || footer.record_number != footers[i].record_number
+            || footer.frame_count != footers[i].frame_count
+            || footer.aux_in_state != footers[i].aux_in_state) {
+            std::ostringstream ostr;
+            ostr << "Error: footer view differs from parsed footer " << i;
+            throw std::runtime_error(ostr.str());
+        }
+    }
+
+    const size_t target = footers.size() / 2;
+    const auto found = std::lower_bound(
+        view.begin(), view.end(), footers[target].trigger_timestamp,
+        [](const T &footer, uint64_t timestamp) {
+            return footer.trigger_timestamp < timestamp;
+        });
+    if (std::distance(view.begin(), found)
+        != static_cast<std::ptrdiff_t>(target))
+        throw std::runtime_error("Error: footer view lower bound failed");
+    const auto last = std::find_if(
+        view.begin(), view.end(), [&](const T &footer) {
+            return footer.record_number == footers.size();
+        });
+    if (last - view.begin() != static_cast<std::ptrdiff_t>(footers.size() - 1))
+        throw std::runtime_error("Error: footer view find failed");
+}
+
+void check_timestamp_unwrapping() {
+    std::cout << "Checking timestamp unwrapping\n";
+    const uint64_t period = uint64_t(1) << 48;
+    const std::vector<uint64_t> raw{period - 300, period - 100, 100,
+                                    300,          period - 50,  50};
+    const std::vector<uint64_t> expected{period - 300,    period - 100,
+                                         period + 100,    period + 300,
+                                         2 * period - 50, 2 * period + 50};
+
+    // Stateful unwrapping across "buffers" of two timestamps
+    ats_timestamp_unwrap_state state{0, 0};
+    std::vector<uint64_t> ticks(raw.size());
+    for (size_t i = 0; i < raw.size(); i += 2)
+        ats_unwrap_timestamps(span<const uint64_t>(raw.data() + i, 2),
+                              span(ticks.data() + i, 2), &state);
+    if (ticks != expected)
+        throw std::runtime_error("Error: stateful timestamp unwrap failed");
+
+    // One-shot unwrapping
+    std::fill(ticks.begin(), ticks.end(), 0);
+    ats_unwrap_timestamps(span<const uint64_t>(raw.data(), raw.size()),
+                          span(ticks.data(), ticks.size()));
+    if (ticks != expected)
+        throw std::runtime_error("Error: one-shot timestamp unwrap failed");
+
+    // 1 GS/s with a divisor of 4 gives 4 ns per tick
+    const std::vector<uint64_t> counts{0, 1, 250000000};
+    std::vector<double> seconds(counts.size());
+    std::vector<int64_t> nanoseconds(counts.size());
+    ats_ticks_to_seconds(span<const uint64_t>(counts.data(), counts.size()),
+                         1e9, 4, span(seconds.data(), seconds.size()));
+    ats_ticks_to_nanoseconds(span<const uint64_t>(counts.data(), counts.size()),
+                             1e9, 4,
+                             span(nanoseconds.data(), nanoseconds.size()));
+    if (nanoseconds != std::vector<int64_t>{0, 4, 1000000000}
+        || std::abs(seconds[2] - 1.) > 1e-12 || seconds[1] != 4e-9)
+        throw std::runtime_error("Error: timestamp conversion failed");
+
+    // Tick counts beyond 2^52 take the same value as a plain conversion
+    const uint64_t large = (uint64_t(1) << 60) + 12345;
+    double large_seconds;
+    ats_ticks_to_seconds(span<const uint64_t>(&large, 1), 1e9, 4,
+                         span(&large_seconds, 1));
+    if (large_seconds != static_cast<double>(large) * (4 / 1e9))
+        throw std::runtime_error("Error: large timestamp conversion failed");
+
+    // At 0.5 ns per tick, odd tick counts fall exactly between two
+    // nanoseconds. Ties round to even whether or not the batch holds tick
+    // counts too large for the fast path, and results saturate past 2^63 ns.
+    const uint64_t big_tie = (uint64_t(1) << 52) + 1; // 2^51 + 0.5 ns
+    const std::vector<uint64_t> ties{1, 3, big_tie, UINT64_MAX};
+    std::vector<int64_t> tie_nanoseconds(ties.size());
+    ats_ticks_to_nanoseconds(span<const uint64_t>(ties.data(), 2), 2e9, 1,
+                             span(tie_nanoseconds.data(), 2));
+    if (tie_nanoseconds[0] != 0 || tie_nanoseconds[1] != 2)
+        throw std::runtime_error("Error: fast nanosecond rounding failed");
+    ats_ticks_to_nanoseconds(span<const uint64_t>(ties.data(), ties.size()),
+                             2e9, 1,
+                             span(tie_nanoseconds.data(), ties.size()));
+    if (tie_nanoseconds
+        != std::vector<int64_t>{0, 2, int64_t(1) << 51, INT64_MAX})
+        throw std::runtime_error("Error: nanosecond rounding failed");
+}
+
+void check_frame_index() {
+    std::cout << "Checking frame index\n";
+    // Frame 0 is complete, frame 1 misses record 5, and frame 3 comes after
+    // frame 1
+    std::vector<ats_footer_type_0> footers{
+        {10, 1, 0, false}, {20, 2, 0, false}, {30, 3, 0, false},
+        {40, 4, 1, false}, {60, 6, 1, false}, {70, 7, 3, false},
+        {80, 8, 3, false}, {90, 9, 3, false},
+    };
+    auto indexer = ats_make_frame_indexer(3);
+
+    // A frame table with room for a single frame makes the indexer stop at
+    // the start of the third frame
+    std::vector<ats_frame_entry> frames(3);
+    auto result = ats_index_frames(
+        &indexer, span<const ats_footer_type_0>(footers.data(), 6),
+        span(frames.data(), 1));
+    if (result.footers_consumed != 5 || result.frames_written != 1)
+        throw std::runtime_error("Error: unexpected frame index result");
+    result = ats_index_frames(
+        &indexer, span<const ats_footer_type_0>(footers.data() + 5, 3),
+        span(frames.data() + 1, 2));
+    if (result.footers_consumed != 3 || result.frames_written != 1
+        || !ats_flush_frame_index(&indexer, &frames[2])
+        || ats_flush_frame_index(&indexer, &frames[2]))
+        throw std::runtime_error("Error: unexpected frame index result");
+
+    const ats_frame_entry expected[] = {
+        {0, 1, 3, ats_frame_flags::none, 10, 30},
+        {1, 4, 2, ats_frame_flags::incomplete | ats_frame_flags::record_gap,
+         40, 60},
+        {3, 7, 3, ats_frame_flags::out_of_order, 70, 90},
+    };
+    for (size_t i = 0; i < 3; i++) {
+        const auto &f = frames[i];
+        const auto &e = expected[i];
+        if (f.frame_count != e.frame_count
+            || f.first_record_number != e.first_record_number
+            || f.record_count != e.record_count || f.flags != e.flags
+            || f.start_timestamp != e.start_timestamp
+            || f.end_timestamp != e.end_timestamp) {
+            std::ostringstream ostr;
+            ostr << "Error: frame entry " << i << " differs from expected";
+            throw std::runtime_error(ostr.str());
+        }
+    }
+
+    // Frame counts wrap around after 2^24 frames
+    const std::vector<ats_footer_type_0> wrapping{
+        {10, 1, 0xFFFFFF, false},
+        {20, 2, 0, false},
+        {30, 3, 2, false},
+    };
+    indexer = ats_make_frame_indexer(1);
+    result = ats_index_frames(&indexer, span(wrapping.data(), wrapping.size()),
+                              span(frames.data(), frames.size()));
+    if (result.footers_consumed != 3 || result.frames_written != 2
+        || !ats_flush_frame_index(&indexer, &frames[2])
+        || frames[0].flags != ats_frame_flags::none
+        || frames[1].flags != ats_frame_flags::none
+        || frames[2].flags != ats_frame_flags::out_of_order)
+        throw std::runtime_error("Error: frame count wrap not handled");
+
+    // Records missing between two frames are flagged on the second frame
+    const std::vector<ats_footer_type_0> boundary_gap{
+        {10, 1, 0, false},
+        {20, 2, 0, false},
+        {40, 4, 1, false},
+        {50, 5, 1, false},
+    };
+    indexer = ats_make_frame_indexer(2);
+    result = ats_index_frames(&indexer,
+                              span(boundary_gap.data(), boundary_gap.size()),
+                              span(frames.data(), frames.size()));
+    if (result.footers_consumed != 4 || result.frames_written != 1
+        || !ats_flush_frame_index(&indexer, &frames[1])
+        || frames[0].flags != ats_frame_flags::none
+        || frames[1].flags != ats_frame_flags::record_gap)
+        throw std::runtime_error("Error: record gap between frames missed");
+}
+
+template <class T>
+void check_footer_probe(span<char> data, ats_footer_configuration config,
+                        span<T> footers) {
+    if (ats_check_footer_configuration(data, config, footers.size())
+        != footers.size())
+        throw std::runtime_error("Error: footer configuration check failed");
+
+    ats_footer_alignment expected;
+    if (!ats_get_footer_alignment(config, &expected))
+        return;
+
+    ats_footer_alignment probed;
+    if (!ats_probe_footer_alignment(
+            data, get_ats_footer_type(config.board_type), &probed)
+        || probed.first_footer_offset_bytes
+               != expected.first_footer_offset_bytes
+        || probed.stride_bytes != expected.stride_bytes
+        || probed.confirmed_footer_count != footers.size()) {
+        std::ostringstream ostr;
+        ostr << "Error: probed footer alignment differs from configuration's ("
+             << probed.first_footer_offset_bytes << "/" << probed.stride_bytes
+             << " instead of " << expected.first_footer_offset_bytes << "/"
+             << expected.stride_bytes << ")";
+        throw std::runtime_error(ostr.str());
+    }
+
+    std::vector<T> scanned(footers.size());
+    const auto result
+        = ats_scan_footers(data, probed, span(scanned.data(), scanned.size()));
+    if (result.footers_parsed != footers.size() || result.resync_count)
+        throw std::runtime_error("Error: footer scan failed");
+    check_record_numbers(record_numbers(span(scanned.data(), scanned.size())));
+}
+
+void check_footer_resync() {
+    std::cout << "Checking footer resync\n";
+    std::ifstream stream{"data-ats9146-1ch-2048spr.bin", std::ios::binary};
+    std::vector<char> contents{std::istreambuf_iterator<char>(stream), {}};
+    const size_t record_size = 2048 * 2;
+    const size_t footer_count = contents.size() / record_size;
+
+    // Turn footer 31 into one that looks like a later record, but is not
+    // followed by its successor
+    ats_footer_internal footer;
+    char *const footer_31 = contents.data() + 31 * record_size - sizeof(footer);
+    memcpy(&footer, footer_31, sizeof(footer));
+    footer = make_internal_footer(
+        0, ats_footer_type_1{parse_trigger_timestamp(&footer) + 1,
+                             parse_record_number(&footer) + 5, 0, false, 0});
+    memcpy(footer_31, &footer, sizeof(footer));
+
+    // Drop 100 bytes from the data of record 71, which shifts the footers
+    // that follow; corrupt the type of footer 50; and start mid-record
+    contents.erase(contents.begin() + 70 * record_size + 100,
+                   contents.begin() + 70 * record_size + 200);
+    contents[50 * record_size - 1] = 0x7F;
+    contents.erase(contents.begin(), contents.begin() + 1000);
+
+    span<char> data{contents.data(), contents.size()};
+    ats_footer_alignment alignment;
+    if (!ats_probe_footer_alignment(data, ats_footer_type::type_0, &alignment)
+        || alignment.stride_bytes != record_size
+        || alignment.first_footer_offset_bytes != record_size - 16 - 1000)
+        throw std::runtime_error("Error: probe failed on truncated data");
+
+    std::vector<ats_footer_type_0> footers(footer_count);
+    const auto result = ats_scan_footers(data, alignment,
+                                         span(footers.data(), footers.size()));
+    if (result.footers_parsed != footer_count - 2 || result.resync_count != 3
+        || result.bytes_skipped != 2 * record_size + 100)
+        throw std::runtime_error("Error: footer scan did not resync");
+    for (size_t i = 0; i < result.footers_parsed; i++) {
+        const uint32_t expected = i < 30 ? i + 1 : i < 48 ? i + 2 : i + 3;
+        if (footers[i].record_number != expected)
+            throw std::runtime_error("Error: resynced footer mismatch");
+    }
+}
+
 struct footer_data_file_config {
     std::string filename;
     ats_footer_configuration config;
@@ -99,6 +617,415 @@ struct footer_data_file_config {
     double expected_ticks_per_trigger;
 };
 
+template <class T>
+void check_simulated_footers(const footer_data_file_config &config) {
+    ats_simulator_configuration simulator{};
+    simulator.footers = config.config;
+    simulator.ticks_per_trigger
+        = static_cast<uint64_t>(config.expected_ticks_per_trigger);
+
+    const auto layout = ats_get_footer_layout(config.config);
+    const size_t buffer_size = layout.buffer_stride_bytes;
+    std::vector<char> data(buffer_size * config.buffers_per_acquisition);
+    auto state = ats_make_simulator_state(1);
+    for (size_t b = 0; b < config.buffers_per_acquisition; b++)
+        ats_fill_simulated_buffer(span(data.data() + b * buffer_size,
+                                       buffer_size),
+                                  simulator, &state);
+
+    std::vector<T> footers(layout.records_per_buffer
+                           * config.buffers_per_acquisition);
+    ats_parse_footers(span(data.data(), data.size()), config.config,
+                      span(footers.data(), footers.size()));
+    check_record_numbers(record_numbers(span(footers.data(), footers.size())));
+    check_timestamps(trigger_timestamps(span(footers.data(), footers.size())),
+                     simulator.ticks_per_trigger);
+}
+
+void check_simulation() {
+    std::cout << "Checking acquisition simulation\n";
+    ats_simulator_configuration simulator{};
+    simulator.footers = {ats_board_type::ats9352,
+                         ats_data_domain::time,
+                         2,
+                         ats_data_layout::sample_interleaved,
+                         2048 * 2,
+                         16,
+                         true};
+    simulator.trigger_rate = 1e6;
+    simulator.ticks_per_trigger = 500;
+    simulator.buffer_count = 4;
+    simulator.buffers_per_acquisition = 64;
+    simulator.drop_probability = 0.01;
+    simulator.corrupt_probability = 0.01;
+    simulator.parser_thread_count = 2;
+    simulator.seed = 42;
+
+    // Anomalies only depend on the seed: each dropped record leaves a gap in
+    // record numbers, and each corrupted footer has an invalid type
+    const auto layout = ats_get_footer_layout(simulator.footers);
+    std::vector<char> buffer(layout.buffer_stride_bytes);
+    const span<char> data(buffer.data(), buffer.size());
+    auto state = ats_make_simulator_state(simulator.seed);
+    size_t records_dropped = 0, footers_corrupted = 0;
+    size_t record_gaps = 0, invalid_types = 0;
+    uint32_t previous_record_number = 0;
+    for (size_t b = 0; b < simulator.buffers_per_acquisition; b++) {
+        const auto stats = ats_fill_simulated_buffer(data, simulator, &state);
+        records_dropped += stats.records_dropped;
+        footers_corrupted += stats.footers_corrupted;
+        for (size_t r = 0; r < layout.records_per_buffer; r++) {
+            ats_footer_internal footer;
+            read_internal_footer(data, layout, r, &footer);
+            const uint32_t record_number = parse_record_number(&footer);
+            record_gaps += record_number - previous_record_number - 1;
+            invalid_types += footer.type != 1;
+            previous_record_number = record_number;
+        }
+    }
+    if (!records_dropped || !footers_corrupted
+        || records_dropped != record_gaps || footers_corrupted != invalid_types)
+        throw std::runtime_error("Error: simulation did not inject anomalies");
+
+    // The threaded run depends on scheduling, so only check its accounting.
+    // Each buffer with a corrupted footer fails to parse.
+    const auto report = ats_run_simulation(simulator);
+    if (report.buffers_acquired + report.buffer_overruns
+            != simulator.buffers_per_acquisition
+        || report.parse_errors > report.footers_corrupted
+        || report.latency_p50_seconds > report.latency_p99_seconds
+        || report.latency_p99_seconds > report.latency_max_seconds) {
+        std::ostringstream ostr;
+        ostr << "Error: inconsistent simulation report. Buffers: "
+             << report.buffers_acquired << ", overruns: "
+             << report.buffer_overruns << ", corrupted: "
+             << report.footers_corrupted
+             << ", parse errors: " << report.parse_errors;
+        throw std::runtime_error(ostr.str());
+    }
+}
+
+void check_latency_correlation() {
+    std::cout << "Checking trigger-to-host latency correlation\n";
+
+    // The board clock runs 20 ppm slow against its nominal 100 MHz. Buffers
+    // of 16 triggers, 10 us apart, are handed over 50 us +/- 3 us after their
+    // last trigger and parsed 100 us later.
+    const double ns_per_tick = 10 * (1 + 20e-6);
+    const size_t triggers_per_buffer = 16;
+    const uint64_t ticks_per_trigger = 1000;
+    const int64_t host_start_ns = 1000000000000;
+    auto correlator = ats_make_clock_correlator({100e6, 1});
+
+    std::vector<uint64_t> ticks(triggers_per_buffer);
+    ats_buffer_latency latency{};
+    for (uint64_t buffer = 0; buffer < 200; buffer++) {
+        for (size_t i = 0; i < triggers_per_buffer; i++)
+            ticks[i] = (buffer * triggers_per_buffer + i) * ticks_per_trigger;
+        const int64_t handover_ns
+            = host_start_ns
+              + static_cast<int64_t>(double(ticks.back()) * ns_per_tick)
+              + 50000 + (static_cast<int64_t>(buffer % 7) - 3) * 1000;
+        latency = ats_correlate_buffer(
+            &correlator, span<const uint64_t>(ticks.data(), ticks.size()),
+            handover_ns, handover_ns + 100000);
+    }
+
+    const auto near = [](double value, double expected, double tolerance) {
+        return std::abs(value - expected) <= tolerance;
+    };
+    const int64_t estimate = ats_estimate_host_time_ns(correlator, ticks[0]);
+    const double expected
+        = double(host_start_ns) + double(ticks[0]) * ns_per_tick + 50000;
+    if (!near(correlator.slope_ns_per_tick, ns_per_tick, 5e-5)
+        || !near(double(estimate), expected, 3000))
+        throw std::runtime_error("Error: clock correlation is inaccurate");
+
+    // The first trigger of a buffer waits 150 us longer than the last
+    if (!near(double(latency.min_ns), 100000, 4000)
+        || !near(double(latency.max_ns), 250000, 4000)
+        || !near(double(latency.p50_ns), 170000, 4000)
+        || latency.p99_ns != latency.max_ns)
+        throw std::runtime_error("Error: unexpected buffer latencies");
+
+    if (correlator.latency_count != 200 * triggers_per_buffer
+        || !near(double(ats_latency_percentile(correlator, 0.5)), 175000,
+                 0.15 * 175000)
+        || !near(double(ats_latency_percentile(correlator, 1)), 250000,
+                 0.15 * 250000))
+        throw std::runtime_error("Error: unexpected latency percentiles");
+}
+
+/// Reads a value of type `T` at `position` in `data`
+template <class T> T read_value(const char *data, size_t position) {
+    T value;
+    memcpy(&value, data + position, sizeof(T));
+    return value;
+}
+
+/// Position of the object that the flatbuffer offset at `position` refers to
+size_t flatbuffer_target(const char *data, size_t position) {
+    return position + read_value<uint32_t>(data, position);
+}
+
+/// Position of field number `field` of the flatbuffer table at `table`
+size_t flatbuffer_field(const char *data, size_t table, size_t field) {
+    const size_t vtable = table - read_value<int32_t>(data, table);
+    if (4 + 2 * field >= read_value<uint16_t>(data, vtable)
+        || !read_value<uint16_t>(data, vtable + 4 + 2 * field))
+        throw std::runtime_error("Error: missing Arrow metadata field");
+    return table + read_value<uint16_t>(data, vtable + 4 + 2 * field);
+}
+
+/// Checks the Arrow export of `data`, whose footers are `footers` except for
+/// row `null_row`, which must be null. Pass `footers.size()` for no null row.
+template <class T>
+void check_arrow_columns(span<char> data, ats_footer_configuration config,
+                         span<T> footers, size_t null_row) {
+    constexpr bool has_analog = std::is_same<T, ats_footer_type_1>::value;
+    const size_t column_count = has_analog ? 5 : 4;
+    const auto footer_type = get_ats_footer_type(config.board_type);
+    for (const auto format :
+         {ats_arrow_format::stream, ats_arrow_format::file}) {
+        std::vector<char> output(
+            ats_arrow_ipc_size(footer_type, footers.size(), format));
+        const size_t written = ats_export_arrow_ipc(
+            data, config, footers.size(), format,
+            span(output.data(), output.size()));
+        if (written != output.size())
+            throw std::runtime_error("Error: unexpected Arrow output size");
+
+        const bool file = format == ats_arrow_format::file;
+        if (file
+            && (memcmp(output.data(), "ARROW1", 6) != 0
+                || memcmp(output.data() + output.size() - 6, "ARROW1", 6)
+                       != 0))
+            throw std::runtime_error("Error: Arrow file magic is missing");
+
+        // Returns the position of the header of the message at `offset`,
+        // relative to the start of the message metadata, and the size of the
+        // message without its body
+        const auto read_message = [&](size_t offset, size_t *header) {
+            if (read_value<uint32_t>(output.data(), offset) != 0xFFFFFFFF)
+                throw std::runtime_error("Error: invalid Arrow message");
+            const char *metadata = output.data() + offset + 8;
+            *header = flatbuffer_target(
+                metadata,
+                flatbuffer_field(metadata, flatbuffer_target(metadata, 0), 2));
+            return 8 + size_t(read_value<uint32_t>(output.data(), offset + 4));
+        };
+
+        size_t schema_header, batch_header;
+        const size_t schema = file ? 8 : 0;
+        const size_t batch = schema + read_message(schema, &schema_header);
+        const size_t body = batch + read_message(batch, &batch_header);
+        if (body % 64)
+            throw std::runtime_error(
+                "Error: Arrow body is not 64-byte aligned");
+
+        const char *schema_metadata = output.data() + schema + 8;
+        const size_t fields = flatbuffer_target(
+            schema_metadata,
+            flatbuffer_field(schema_metadata, schema_header, 1));
+        if (read_value<uint32_t>(schema_metadata, fields) != column_count)
+            throw std::runtime_error("Error: unexpected Arrow field count");
+
+        // Each column has a validity bitmap and a values buffer, whose
+        // locations relative to the body are listed by the record batch
+        const char *batch_metadata = output.data() + batch + 8;
+        if (read_value<int64_t>(batch_metadata,
+                                flatbuffer_field(batch_metadata, batch_header,
+                                                 0))
+            != static_cast<int64_t>(footers.size()))
+            throw std::runtime_error("Error: unexpected Arrow row count");
+        const size_t nodes = flatbuffer_target(
+            batch_metadata, flatbuffer_field(batch_metadata, batch_header, 1));
+        if (read_value<uint32_t>(batch_metadata, nodes) != column_count)
+            throw std::runtime_error("Error: unexpected Arrow node count");
+        const int64_t null_count = null_row < footers.size() ? 1 : 0;
+        for (size_t c = 0; c < column_count; c++)
+            if (read_value<int64_t>(batch_metadata, nodes + 4 + 16 * c)
+                    != static_cast<int64_t>(footers.size())
+                || read_value<int64_t>(batch_metadata, nodes + 12 + 16 * c)
+                       != null_count)
+                throw std::runtime_error("Error: unexpected Arrow null count");
+        const size_t buffers = flatbuffer_target(
+            batch_metadata, flatbuffer_field(batch_metadata, batch_header, 2));
+        if (read_value<uint32_t>(batch_metadata, buffers)
+            != 2 * column_count)
+            throw std::runtime_error("Error: unexpected Arrow buffer count");
+        size_t offsets[10];
+        for (size_t b = 0; b < 2 * column_count; b++)
+            offsets[b] = body
+                         + static_cast<size_t>(read_value<int64_t>(
+                             batch_metadata, buffers + 4 + 16 * b));
+
+        const auto bit = [&](size_t buffer, size_t i) {
+            return ((output[offsets[buffer] + i / 8] >> (i % 8)) & 1) != 0;
+        };
+        for (size_t i = 0; i < footers.size(); i++) {
+            // Null rows are zero in all columns
+            const T footer = i == null_row ? T{} : footers[i];
+            for (size_t c = 0; c < column_count; c++)
+                if (bit(2 * c, i) != (i != null_row))
+                    throw std::runtime_error(
+                        "Error: unexpected Arrow validity bit");
+            if (read_value<uint64_t>(output.data(), offsets[1] + 8 * i)
+                    != footer.trigger_timestamp
+                || read_value<uint32_t>(output.data(), offsets[3] + 4 * i)
+                       != footer.record_number
+                || read_value<uint32_t>(output.data(), offsets[5] + 4 * i)
+                       != footer.frame_count
+                || bit(7, i) != footer.aux_in_state)
+                throw std::runtime_error(
+                    "Error: Arrow column differs from parsed footers");
+            if constexpr (has_analog) {
+                if (read_value<int16_t>(output.data(), offsets[9] + 2 * i)
+                    != footer.analog_value)
+                    throw std::runtime_error(
+                        "Error: Arrow column differs from parsed footers");
+            }
+        }
+    }
+}
+
+template <class T>
+void check_arrow_export(span<char> data, ats_footer_configuration config,
+                        span<T> footers) {
+    check_arrow_columns(data, config, footers, footers.size());
+
+    // A footer with an invalid type becomes a null row
+    const auto layout = ats_get_footer_layout(config);
+    const size_t null_row = footers.size() / 2;
+    std::vector<char> corrupted(data.data(), data.data() + data.size());
+    ats_footer_internal footer;
+    read_internal_footer(data, layout, null_row, &footer);
+    footer.type = 0x7F;
+    write_internal_footer(span(corrupted.data(), corrupted.size()), layout,
+                          null_row, &footer);
+    check_arrow_columns(span(corrupted.data(), corrupted.size()), config,
+                        footers, null_row);
+
+    // Data that is too short for the footers is rejected before any output
+    const auto footer_type = get_ats_footer_type(config.board_type);
+    std::vector<char> output(ats_arrow_ipc_size(
+        footer_type, footers.size(), ats_arrow_format::stream));
+    bool rejected = false;
+    try {
+        ats_export_arrow_ipc(
+            span(data.data(), footer_data_size(layout, footers.size()) - 1),
+            config, footers.size(), ats_arrow_format::stream,
+            span(output.data(), output.size()));
+    } catch (const std::runtime_error &) {
+        rejected = true;
+    }
+    if (!rejected)
+        throw std::runtime_error("Error: short Arrow input was accepted");
+}
+
+/// Memory resource whose allocations fail with an exception other than
+/// `std::bad_alloc`
+class failing_resource : public std::pmr::memory_resource {
+  private:
+    void *do_allocate(size_t, size_t) override {
+        throw std::runtime_error("Error: allocation failed");
+    }
+
+    void do_deallocate(void *, size_t, size_t) override {}
+
+    bool do_is_equal(const memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+template <class T>
+void check_scratch_parsing(span<char> data, ats_footer_configuration config,
+                           span<T> footers) {
+    std::vector<T> parsed(footers.size());
+    std::vector<char> scratch(ats_footer_scratch_size(footers.size()));
+    std::vector<char> arena(scratch.size());
+    char error_message[256];
+    const span<char> error(error_message, sizeof(error_message));
+
+    // Warm up the thread-local scratch memory of the throwing overload
+    ats_parse_footers(data, config, span(parsed.data(), parsed.size()));
+
+    const size_t allocations = allocation_count;
+    for (int i = 0; i < 4; i++) {
+        std::pmr::monotonic_buffer_resource resource(
+            arena.data(), arena.size(), std::pmr::null_memory_resource());
+        ats_parse_footers(data, config, span(parsed.data(), parsed.size()));
+        if (ats_parse_footers(data, config,
+                              span(parsed.data(), parsed.size()),
+                              span(scratch.data(), scratch.size()), error)
+            || ats_parse_footers(data, config,
+                                 span(parsed.data(), parsed.size()),
+                                 &resource, error))
+            throw std::runtime_error(error_message);
+    }
+
+    // Errors are reported without allocating either
+    auto invalid = config;
+    invalid.records_per_buffer_per_channel = 0;
+    const int too_small_result = ats_parse_footers(
+        data, config, span(parsed.data(), parsed.size()),
+        span(scratch.data(), scratch.size() / 2), error);
+    const int invalid_result = ats_parse_footers(
+        data, invalid, span(parsed.data(), parsed.size()),
+        span(scratch.data(), scratch.size()), error);
+    if (allocation_count != allocations)
+        throw std::runtime_error("Error: footer parsing allocated memory");
+
+    if (too_small_result != -1 || invalid_result != -1
+        || strcmp(error_message, "Error: records per buffer is 0") != 0)
+        throw std::runtime_error("Error: footer parsing did not fail");
+
+    // So are unsupported board types, and any failure of a memory resource
+    auto unsupported = config;
+    unsupported.board_type = ats_board_type::ats9874;
+    if (ats_parse_footers(data, unsupported,
+                          span(parsed.data(), parsed.size()),
+                          span(scratch.data(), scratch.size()), error)
+            != -1
+        || strncmp(error_message, "Error: board type", 17) != 0)
+        throw std::runtime_error("Error: unsupported board type accepted");
+    failing_resource failing;
+    if (ats_parse_footers(data, config, span(parsed.data(), parsed.size()),
+                          &failing, error)
+            != -1
+        || strncmp(error_message, "Error: could not allocate", 25) != 0)
+        throw std::runtime_error("Error: memory resource failure not caught");
+    if (ats_parse_footers(data, config, span(parsed.data(), parsed.size()),
+                          static_cast<std::pmr::memory_resource *>(nullptr),
+                          error)
+            != -1
+        || strcmp(error_message, "Error: NULL memory resource") != 0)
+        throw std::runtime_error("Error: NULL memory resource accepted");
+
+    // An invalid last footer leaves all output footers untouched
+    const auto layout = ats_get_footer_layout(config);
+    std::vector<char> corrupted(data.data(), data.data() + data.size());
+    ats_footer_internal footer;
+    read_internal_footer(data, layout, footers.size() - 1, &footer);
+    footer.type = 0x7F;
+    write_internal_footer(span(corrupted.data(), corrupted.size()), layout,
+                          footers.size() - 1, &footer);
+    std::vector<T> untouched(footers.size());
+    if (ats_parse_footers(span(corrupted.data(), corrupted.size()), config,
+                          span(untouched.data(), untouched.size()),
+                          span(scratch.data(), scratch.size()), error)
+            != -1
+        || std::any_of(untouched.begin(), untouched.end(),
+                       [](const T &f) { return f.record_number != 0; }))
+        throw std::runtime_error("Error: invalid footer was partly parsed");
+
+    for (size_t i = 0; i < footers.size(); i++)
+        if (parsed[i].trigger_timestamp != footers[i].trigger_timestamp
+            || parsed[i].record_number != footers[i].record_number)
+            throw std::runtime_error(
+                "Error: scratch parsing differs from parsed footers");
+}
+
 void check_data_file(footer_data_file_config config) {
     try {
         std::cout << "Checking data file " << config.filename << "\n";
@@ -119,6 +1046,18 @@ void check_data_file(footer_data_file_config config) {
             check_timestamps(
                 trigger_timestamps(span(footers.data(), footers.size())),
                 static_cast<uint64_t>(config.expected_ticks_per_trigger));
+            check_trigger_statistics(
+                data, config.config, span(footers.data(), footers.size()),
+                static_cast<uint64_t>(config.expected_ticks_per_trigger));
+            check_footer_view(data, config.config,
+                              span(footers.data(), footers.size()));
+            check_footer_probe(data, config.config,
+                               span(footers.data(), footers.size()));
+            check_scratch_parsing(data, config.config,
+                                  span(footers.data(), footers.size()));
+            check_arrow_export(data, config.config,
+                               span(footers.data(), footers.size()));
+            check_simulated_footers<ats_footer_type_0>(config);
             break;
         }
         case ats_footer_type::type_1: {
@@ -132,6 +1071,20 @@ void check_data_file(footer_data_file_config config) {
             check_timestamps(
                 trigger_timestamps(span(footers.data(), footers.size())),
                 static_cast<uint64_t>(config.expected_ticks_per_trigger));
+            check_trigger_statistics(
+                data, config.config, span(footers.data(), footers.size()),
+                static_cast<uint64_t>(config.expected_ticks_per_trigger));
+            check_footer_view(data, config.config,
+                              span(footers.data(), footers.size()));
+            check_footer_probe(data, config.config,
+                               span(footers.data(), footers.size()));
+            check_scratch_parsing(data, config.config,
+                                  span(footers.data(), footers.size()));
+            check_arrow_export(data, config.config,
+                               span(footers.data(), footers.size()));
+            check_simulated_footers<ats_footer_type_1>(config);
+            check_analog_values(data, config.config,
+                                span(footers.data(), footers.size()));
             break;
         }
         default:
@@ -144,6 +1097,137 @@ void check_data_file(footer_data_file_config config) {
     }
 }
 
+#ifdef ATS_HAVE_RING
+/// Publishes footers from one thread while another thread reads them through
+/// a small ring, and checks that every footer read is consistent, in order,
+/// and that footers read plus footers lost account for all published ones
+void check_concurrent_footer_ring(const std::string &name) {
+    const size_t capacity = 16;
+    const uint32_t footer_count = 200000;
+    ats_footer_ring *publisher = ats_footer_ring_create(
+        name.c_str(), ats_footer_type::type_0, capacity);
+    ats_footer_ring *subscriber = ats_footer_ring_open(name.c_str());
+
+    // Every field is derived from the record number, so that a footer mixing
+    // two publications is detected
+    const auto make_footer = [](uint32_t record_number) {
+        return ats_footer_type_0{1000 * uint64_t(record_number),
+                                 record_number,
+                                 record_number * 7 & 0xFFFFFF,
+                                 record_number % 2 == 0};
+    };
+    std::thread publishing([&]() {
+        std::vector<ats_footer_type_0> batch;
+        for (uint32_t r = 1; r <= footer_count;) {
+            batch.clear();
+            for (size_t i = 0; i < 5 && r <= footer_count; i++)
+                batch.push_back(make_footer(r++));
+            ats_footer_ring_publish(publisher,
+                                    span<const ats_footer_type_0>(
+                                        batch.data(), batch.size()));
+            // Let the subscriber run, but not always before it is lapped
+            if (r % 20 == 1)
+                std::this_thread::yield();
+        }
+    });
+
+    uint64_t read = 0;
+    uint64_t lost = 0;
+    uint32_t last = 0;
+    bool consistent = true;
+    ats_footer_type_0 received[3];
+    while (last != footer_count && consistent) {
+        const auto result
+            = ats_footer_ring_read(subscriber, span(received, 3));
+        read += result.footers_read;
+        lost += result.footers_lost;
+        if (!result.footers_read)
+            std::this_thread::yield();
+        for (size_t i = 0; i < result.footers_read; i++) {
+            const auto expected = make_footer(received[i].record_number);
+            consistent = consistent
+                         && received[i].record_number > last
+                         && received[i].trigger_timestamp
+                                == expected.trigger_timestamp
+                         && received[i].frame_count == expected.frame_count
+                         && received[i].aux_in_state
+                                == expected.aux_in_state;
+            last = received[i].record_number;
+        }
+    }
+    publishing.join();
+    ats_footer_ring_close(subscriber);
+    ats_footer_ring_close(publisher);
+    ats_footer_ring_unlink(name.c_str());
+
+    if (!consistent)
+        throw std::runtime_error("Error: torn or out-of-order ring footer");
+    if (read + lost != footer_count)
+        throw std::runtime_error(
+            "Error: footers read and lost do not add up to footers published");
+}
+
+void check_footer_ring() {
+    std::cout << "Checking shared-memory footer ring\n";
+    const std::string name
+        = "/atsfooters-test-" + std::to_string(static_cast<long>(getpid()));
+    const size_t capacity = 8;
+    ats_footer_ring *publisher = ats_footer_ring_create(
+        name.c_str(), ats_footer_type::type_0, capacity);
+    ats_footer_ring *subscriber = ats_footer_ring_open(name.c_str());
+    try {
+        std::vector<ats_footer_type_0> published(capacity * 3);
+        for (size_t i = 0; i < published.size(); i++)
+            published[i]
+                = {1000 * i, static_cast<uint32_t>(i + 1), 0, i % 2 == 0};
+        std::vector<ats_footer_type_0> received(capacity * 3);
+
+        // Footers that fit in the ring are all received
+        ats_footer_ring_publish(
+            publisher, span<const ats_footer_type_0>(published.data(), 5));
+        auto result = ats_footer_ring_read(
+            subscriber, span(received.data(), received.size()));
+        if (result.footers_read != 5 || result.footers_lost != 0)
+            throw std::runtime_error("Error: footer ring read mismatch");
+        check_record_numbers(record_numbers(span(received.data(), 5)));
+
+        // A subscriber that is lapped by the publisher is told how many
+        // footers it missed, and receives the most recent ones
+        ats_footer_ring_publish(
+            publisher, span<const ats_footer_type_0>(published.data() + 5,
+                                                     published.size() - 5));
+        result = ats_footer_ring_read(subscriber,
+                                      span(received.data(), received.size()));
+        if (result.footers_read != capacity
+            || result.footers_lost != published.size() - 5 - capacity
+            || received[0].record_number != published.size() - capacity + 1)
+            throw std::runtime_error("Error: footer ring lag not detected");
+
+        // Subscribers map the ring read-only and cannot publish
+        bool rejected = false;
+        try {
+            ats_footer_ring_publish(
+                subscriber, span<const ats_footer_type_0>(published.data(), 1));
+        } catch (const std::runtime_error &) {
+            rejected = true;
+        }
+        if (!rejected)
+            throw std::runtime_error(
+                "Error: footer ring subscriber was allowed to publish");
+    } catch (...) {
+        ats_footer_ring_close(subscriber);
+        ats_footer_ring_close(publisher);
+        ats_footer_ring_unlink(name.c_str());
+        throw;
+    }
+    ats_footer_ring_close(subscriber);
+    ats_footer_ring_close(publisher);
+    ats_footer_ring_unlink(name.c_str());
+
+    check_concurrent_footer_ring(name);
+}
+#endif
+
 // clang-format off
 static const footer_data_file_config footer_data_file_configs[] = {
     // filename                      | board type             | data domain               | ch. count | data layout                        | bytes/rec | rec/buf | fifo   | buf/acq. | ticks per trig |
@@ -170,6 +1254,17 @@ int main() {
         for (auto config : footer_data_file_configs) {
             check_data_file(config);
         }
+        check_analog_mean();
+        check_missed_records();
+        check_statistics_merge_across_wrap();
+        check_timestamp_unwrapping();
+        check_frame_index();
+        check_footer_resync();
+        check_simulation();
+        check_latency_correlation();
+#ifdef ATS_HAVE_RING
+        check_footer_ring();
+#endif
     } catch (const std::exception &e) {
         std::cerr << "test_atsfooters error: " << e.what();
         return -1;
@@ -0,0 +1,57 @@
+# Runs atsfooters-dump on a sample data file and compares its output with the
+# known footers of the file, then checks that invalid inputs are rejected.
+#
+# Usage: cmake -DDUMP=<atsfooters-dump> -DDATA_DIR=<dir> -DWORK_DIR=<dir>
+#              -P test_atsfooters_dump.cmake
+
+set(SAMPLE data-ats9146-2ch-2048spr)
+set(CONFIGURATION --board ats9146 --channels 2 --layout buffer
+  --record-bytes 4096)
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+# Splitting the file into several chunks must not change the output
+execute_process(
+  COMMAND ${DUMP} ${CONFIGURATION} --records-per-buffer 10 --format csv
+    --output-dir ${WORK_DIR} --chunk-bytes 245760 --threads 4
+    ${DATA_DIR}/${SAMPLE}.bin
+  RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+  message(FATAL_ERROR "atsfooters-dump failed: ${result}")
+endif ()
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E compare_files
+    ${WORK_DIR}/${SAMPLE}.footers.csv ${DATA_DIR}/${SAMPLE}.footers.csv
+  RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+  message(FATAL_ERROR "${SAMPLE}.footers.csv differs from expected")
+endif ()
+
+# Each case must be rejected with a usage error, before any output is written
+function(check_rejected name)
+  file(REMOVE_RECURSE ${WORK_DIR}/${name})
+  execute_process(
+    COMMAND ${DUMP} ${ARGN} --output-dir ${WORK_DIR}/${name}
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error)
+  if (NOT result EQUAL 2)
+    message(FATAL_ERROR "${name}: expected exit code 2, got ${result}")
+  endif ()
+  if (EXISTS ${WORK_DIR}/${name})
+    message(FATAL_ERROR "${name}: output was written")
+  endif ()
+  string(STRIP "${error}" error)
+  message(STATUS "${name}: ${error}")
+endfunction()
+
+check_rejected(unsupported_board
+  --board ats9874 --record-bytes 4096 --records-per-buffer 10
+  ${DATA_DIR}/${SAMPLE}.bin)
+check_rejected(partial_buffer
+  ${CONFIGURATION} --records-per-buffer 11 ${DATA_DIR}/${SAMPLE}.bin)
+check_rejected(smaller_than_buffer
+  ${CONFIGURATION} --records-per-buffer 101 ${DATA_DIR}/${SAMPLE}.bin)
+check_rejected(output_collision
+  ${CONFIGURATION} --records-per-buffer 10 ${DATA_DIR}/${SAMPLE}.bin
+  ${DATA_DIR}/./${SAMPLE}.bin)
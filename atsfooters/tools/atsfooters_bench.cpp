@@ -0,0 +1,172 @@
+///
+/// @file
+///
+/// Command-line tool that measures the throughput of the library's hot loops
+/// on synthetic data, next to plain scalar loops that compute the same
+/// results. Only optimized builds (e.g. `-DCMAKE_BUILD_TYPE=Release`) give
+/// representative numbers.
+///
+
+#include "atsfooters.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "atsfooters_probe.hpp"
+#include "atsfooters_sim.hpp"
+#include "atsfooters_time.hpp"
+
+namespace {
+
+/// Number of times each benchmark runs. The fastest run is reported.
+const int run_count = 5;
+
+/// Runs `function` `run_count` times, and returns the duration of the fastest
+/// run in seconds
+template <class Function> double best_time(Function function) {
+    double best = 1e300;
+    for (int run = 0; run < run_count; run++) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best,
+                        std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+void report(const char *name, size_t element_count, size_t byte_count,
+            double seconds) {
+    std::cout << name << ": " << element_count / seconds / 1e6
+              << " M elements/s, " << byte_count / seconds / 1e9
+              << " GB/s\n";
+}
+
+void bench_time_conversion() {
+    const size_t count = size_t(1) << 24;
+    std::vector<uint64_t> ticks(count);
+    for (size_t i = 0; i < count; i++)
+        ticks[i] = 1000 * uint64_t(i) + i % 7;
+    std::vector<double> seconds(count);
+    std::vector<int64_t> nanoseconds(count);
+    const span<const uint64_t> input(ticks.data(), ticks.size());
+    const double sample_rate = 1e9;
+    const uint32_t divisor = 4;
+    const double scale = divisor / sample_rate;
+    const size_t bytes = count * sizeof(uint64_t);
+
+    report("ats_ticks_to_seconds", count, bytes, best_time([&]() {
+               ats_ticks_to_seconds(input, sample_rate, divisor,
+                                    span(seconds.data(), seconds.size()));
+           }));
+    report("scalar ticks to seconds", count, bytes, best_time([&]() {
+               for (size_t i = 0; i < count; i++)
+                   seconds[i] = static_cast<double>(ticks[i]) * scale;
+           }));
+    report("ats_ticks_to_nanoseconds", count, bytes, best_time([&]() {
+               ats_ticks_to_nanoseconds(
+                   input, sample_rate, divisor,
+                   span(nanoseconds.data(), nanoseconds.size()));
+           }));
+    report("scalar ticks to nanoseconds", count, bytes, best_time([&]() {
+               for (size_t i = 0; i < count; i++)
+                   nanoseconds[i] = static_cast<int64_t>(std::nearbyint(
+                       static_cast<double>(ticks[i]) * scale * 1e9));
+           }));
+}
+
+/// Fills `data` with pseudo-random bytes
+void fill_random(span<char> data, uint64_t *random) {
+    for (size_t i = 0; i + sizeof(*random) <= data.size();
+         i += sizeof(*random)) {
+        *random ^= *random << 13;
+        *random ^= *random >> 7;
+        *random ^= *random << 17;
+        memcpy(data.data() + i, random, sizeof(*random));
+    }
+}
+
+/// Scans 256 MiB of records with random samples, dropped records and
+/// corrupted footers. Every 8191 records, 100 bytes are missing, which shifts
+/// the footers that follow, and one 16 MiB DMA buffer is overwritten with
+/// random bytes, which the scan has to search through.
+void bench_footer_scan() {
+    ats_simulator_configuration simulator{};
+    simulator.footers.board_type = ats_board_type::ats9352;
+    simulator.footers.data_domain = ats_data_domain::time;
+    simulator.footers.active_channel_count = 1;
+    simulator.footers.data_layout = ats_data_layout::buffer_interleaved;
+    simulator.footers.bytes_per_record_per_channel = 4096;
+    simulator.footers.records_per_buffer_per_channel = 4096;
+    simulator.ticks_per_trigger = 1000;
+    simulator.drop_probability = 1e-3;
+    simulator.corrupt_probability = 1e-3;
+    const size_t buffer_count = 16;
+    const size_t record_size = simulator.footers.bytes_per_record_per_channel;
+    const size_t buffer_size
+        = record_size * simulator.footers.records_per_buffer_per_channel;
+
+    std::vector<char> acquired(buffer_size * buffer_count);
+    uint64_t random = 0x9E3779B97F4A7C15;
+    fill_random(span<char>(acquired.data(), acquired.size()), &random);
+    auto state = ats_make_simulator_state(1);
+    for (size_t b = 0; b < buffer_count; b++)
+        ats_fill_simulated_buffer(
+            span<char>(acquired.data() + b * buffer_size, buffer_size),
+            simulator, &state);
+    fill_random(span<char>(acquired.data() + buffer_count / 2 * buffer_size,
+                           buffer_size),
+                &random);
+
+    const size_t shift_period = 8191 * record_size;
+    const size_t shift_bytes = 100;
+    std::vector<char> contents;
+    contents.reserve(acquired.size());
+    for (size_t p = 0; p < acquired.size(); p += shift_period) {
+        const size_t end = std::min(acquired.size(), p + shift_period);
+        contents.insert(contents.end(), acquired.begin() + p,
+                        acquired.begin() + end);
+        if (end - p > shift_bytes)
+            contents.resize(contents.size() - shift_bytes);
+    }
+
+    ats_footer_alignment alignment;
+    if (!ats_get_footer_alignment(simulator.footers, &alignment))
+        throw std::runtime_error("Error: footers are not at a constant stride");
+    const span<char> data(contents.data(), contents.size());
+    std::vector<ats_footer_type_1> footers(contents.size() / record_size);
+    ats_footer_scan_result result{};
+    report("ats_scan_footers", footers.size(), contents.size(),
+           best_time([&]() {
+               result = ats_scan_footers(
+                   data, alignment, span(footers.data(), footers.size()));
+           }));
+    std::cout << "  " << result.footers_parsed << " footers, "
+              << result.resync_count << " resyncs, " << result.bytes_skipped
+              << " bytes skipped\n";
+}
+
+} // namespace
+
+int main() {
+#ifndef NDEBUG
+    std::cerr << "atsfooters-bench: warning: built with assertions, probably "
+                 "without optimization\n";
+#endif
+    try {
+        bench_time_conversion();
+        bench_footer_scan();
+    } catch (const std::exception &e) {
+        std::cerr << "atsfooters-bench: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,553 @@
+///
+/// @file
+///
+/// Command-line tool that extracts the record footers of capture files, i.e.
+/// files holding a sequence of DMA buffers, and writes them out as tables.
+///
+/// Files are split into chunks of whole DMA buffers. Worker threads take
+/// chunks from a shared queue, so that threads that finish with small files go
+/// on to help with the chunks of large ones. Output for each file is written
+/// in order as chunks complete.
+///
+
+#include "atsfooters.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+enum class output_format {
+    binary,
+    csv,
+    columnar,
+};
+
+struct options {
+    ats_footer_configuration configuration;
+    output_format format;
+    fs::path output_directory;
+    size_t thread_count;
+    size_t chunk_bytes;
+    std::vector<fs::path> inputs;
+};
+
+const char usage[] = R"(Usage: atsfooters-dump [OPTIONS] FILE...
+
+Extracts the record footers of capture files and writes them as tables.
+
+Acquisition configuration:
+  --board NAME             Board type, e.g. ats9352 (required)
+  --domain time|frequency  Data domain (default: time)
+  --channels N             Active channel count (default: 1)
+  --layout L               Data layout: buffer, record or sample interleaved
+                           (default: sample)
+  --record-bytes N         Bytes per record per channel (required)
+  --records-per-buffer N   Records per buffer per channel (required)
+  --fifo                   Acquisition used ADMA_FIFO_ONLY_STREAMING
+
+Output:
+  --format F               binary, csv or columnar (default: csv)
+  --output-dir DIR         Directory for output files (default: .)
+
+  Output files are named after the input files without their extension, so
+  input file names must differ by more than their extension. Each input file
+  must hold a whole number of DMA buffers.
+
+  The `binary` format writes one packed little-endian row per footer:
+  trigger_timestamp (u64), record_number (u32), frame_count (u32),
+  aux_in_state (u8) and, for type 1 footers, analog_value (i16).
+  The `columnar` format writes each of these columns to a separate file.
+
+Processing:
+  --threads N              Worker thread count (default: hardware threads)
+  --chunk-bytes N          Bytes of DMA buffers per unit of work, rounded down
+                           to whole buffers (default: 33554432, i.e. 32 MiB)
+)";
+
+/// Board types that the library can parse footers of
+// clang-format off
+const std::map<std::string, ats_board_type> board_names = {
+    {"ats850",  ats_board_type::ats850 }, {"ats310",  ats_board_type::ats310 },
+    {"ats330",  ats_board_type::ats330 }, {"ats460",  ats_board_type::ats460 },
+    {"ats860",  ats_board_type::ats860 }, {"ats660",  ats_board_type::ats660 },
+    {"ats9462", ats_board_type::ats9462}, {"ats9434", ats_board_type::ats9434},
+    {"ats9870", ats_board_type::ats9870}, {"ats9350", ats_board_type::ats9350},
+    {"ats9325", ats_board_type::ats9325}, {"ats9440", ats_board_type::ats9440},
+    {"ats9410", ats_board_type::ats9410}, {"ats9351", ats_board_type::ats9351},
+    {"ats9310", ats_board_type::ats9310}, {"ats9461", ats_board_type::ats9461},
+    {"ats9850", ats_board_type::ats9850}, {"ats9625", ats_board_type::ats9625},
+    {"ats9626", ats_board_type::ats9626}, {"ats9360", ats_board_type::ats9360},
+    {"axi9870", ats_board_type::axi9870}, {"ats9370", ats_board_type::ats9370},
+    {"atu7825", ats_board_type::atu7825}, {"ats9373", ats_board_type::ats9373},
+    {"ats9416", ats_board_type::ats9416}, {"ats9637", ats_board_type::ats9637},
+    {"ats9120", ats_board_type::ats9120}, {"ats9371", ats_board_type::ats9371},
+    {"ats9130", ats_board_type::ats9130}, {"ats9352", ats_board_type::ats9352},
+    {"ats9453", ats_board_type::ats9453}, {"ats9146", ats_board_type::ats9146},
+    {"ats9000", ats_board_type::ats9000}, {"ats9437", ats_board_type::ats9437},
+    {"ats9618", ats_board_type::ats9618}, {"ats9358", ats_board_type::ats9358},
+    {"forest",  ats_board_type::forest }, {"ats9353", ats_board_type::ats9353},
+    {"ats9872", ats_board_type::ats9872}, {"ats9470", ats_board_type::ats9470},
+    {"ats9628", ats_board_type::ats9628}, {"ats4001", ats_board_type::ats4001},
+    {"ats9364", ats_board_type::ats9364},
+};
+// clang-format on
+
+size_t parse_count(const std::string &flag, const std::string &value) {
+    size_t result = 0;
+    const auto end = value.data() + value.size();
+    const auto [ptr, ec] = std::from_chars(value.data(), end, result);
+    if (ec != std::errc() || ptr != end || !result) {
+        std::ostringstream ostr;
+        ostr << "Error: invalid value '" << value << "' for " << flag;
+        throw std::runtime_error(ostr.str());
+    }
+    return result;
+}
+
+options parse_options(int argc, char *argv[]) {
+    options opts{};
+    opts.configuration.data_domain = ats_data_domain::time;
+    opts.configuration.active_channel_count = 1;
+    opts.configuration.data_layout = ats_data_layout::sample_interleaved;
+    opts.format = output_format::csv;
+    opts.output_directory = ".";
+    opts.thread_count = std::max(1u, std::thread::hardware_concurrency());
+    opts.chunk_bytes = size_t(32) << 20;
+
+    bool has_board = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc)
+                throw std::runtime_error("Error: missing value for " + arg);
+            return argv[++i];
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            std::cout << usage;
+            exit(0);
+        } else if (arg == "--board") {
+            const auto name = value();
+            const auto board = board_names.find(name);
+            if (board == board_names.end())
+                throw std::runtime_error("Error: unsupported board type "
+                                         + name);
+            opts.configuration.board_type = board->second;
+            has_board = true;
+        } else if (arg == "--domain") {
+            const auto name = value();
+            if (name == "time")
+                opts.configuration.data_domain = ats_data_domain::time;
+            else if (name == "frequency")
+                opts.configuration.data_domain = ats_data_domain::frequency;
+            else
+                throw std::runtime_error("Error: unknown data domain " + name);
+        } else if (arg == "--channels") {
+            opts.configuration.active_channel_count = parse_count(arg, value());
+        } else if (arg == "--layout") {
+            const auto name = value();
+            if (name == "buffer")
+                opts.configuration.data_layout
+                    = ats_data_layout::buffer_interleaved;
+            else if (name == "record")
+                opts.configuration.data_layout
+                    = ats_data_layout::record_interleaved;
+            else if (name == "sample")
+                opts.configuration.data_layout
+                    = ats_data_layout::sample_interleaved;
+            else
+                throw std::runtime_error("Error: unknown data layout " + name);
+        } else if (arg == "--record-bytes") {
+            opts.configuration.bytes_per_record_per_channel
+                = parse_count(arg, value());
+        } else if (arg == "--records-per-buffer") {
+            opts.configuration.records_per_buffer_per_channel
+                = parse_count(arg, value());
+        } else if (arg == "--fifo") {
+            opts.configuration.fifo = true;
+        } else if (arg == "--format") {
+            const auto name = value();
+            if (name == "binary")
+                opts.format = output_format::binary;
+            else if (name == "csv")
+                opts.format = output_format::csv;
+            else if (name == "columnar")
+                opts.format = output_format::columnar;
+            else
+                throw std::runtime_error("Error: unknown output format "
+                                         + name);
+        } else if (arg == "--output-dir") {
+            opts.output_directory = value();
+        } else if (arg == "--threads") {
+            opts.thread_count = parse_count(arg, value());
+        } else if (arg == "--chunk-bytes") {
+            opts.chunk_bytes = parse_count(arg, value());
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            throw std::runtime_error("Error: unknown option " + arg);
+        } else {
+            opts.inputs.push_back(arg);
+        }
+    }
+
+    if (!has_board)
+        throw std::runtime_error("Error: --board is required");
+    if (!opts.configuration.bytes_per_record_per_channel)
+        throw std::runtime_error("Error: --record-bytes is required");
+    if (!opts.configuration.records_per_buffer_per_channel)
+        throw std::runtime_error("Error: --records-per-buffer is required");
+    if (opts.inputs.empty())
+        throw std::runtime_error("Error: no input file");
+
+    return opts;
+}
+
+/// Output columns, in table order
+struct column {
+    const char *name;
+    size_t size_bytes;
+};
+
+const column columns[] = {
+    {"trigger_timestamp", 8}, {"record_number", 4}, {"frame_count", 4},
+    {"aux_in_state", 1},      {"analog_value", 2},
+};
+
+size_t column_count(ats_footer_type footer_type) {
+    return footer_type == ats_footer_type::type_1 ? 5 : 4;
+}
+
+template <class T> void append_bytes(std::string &out, T value) {
+    // Output files are little-endian, like the platforms that the library
+    // supports
+    char bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+template <class T> void append_text(std::string &out, T value) {
+    char text[24];
+    const auto result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr);
+}
+
+/// Formats footers for output. `streams` holds one string per output file.
+template <class T>
+void format_footers(span<T> footers, output_format format,
+                    std::vector<std::string> &streams) {
+    constexpr bool has_analog = std::is_same<T, ats_footer_type_1>::value;
+    switch (format) {
+    case output_format::binary: {
+        auto &out = streams[0];
+        out.reserve(footers.size() * (has_analog ? 19 : 17));
+        for (const auto &f : footers) {
+            append_bytes(out, f.trigger_timestamp);
+            append_bytes(out, f.record_number);
+            append_bytes(out, f.frame_count);
+            append_bytes(out, uint8_t(f.aux_in_state));
+            if constexpr (has_analog)
+                append_bytes(out, f.analog_value);
+        }
+        break;
+    }
+    case output_format::csv: {
+        auto &out = streams[0];
+        out.reserve(footers.size() * 48);
+        for (const auto &f : footers) {
+            append_text(out, f.trigger_timestamp);
+            out += ',';
+            append_text(out, f.record_number);
+            out += ',';
+            append_text(out, f.frame_count);
+            out += ',';
+            out += f.aux_in_state ? '1' : '0';
+            if constexpr (has_analog) {
+                out += ',';
+                append_text(out, f.analog_value);
+            }
+            out += '\n';
+        }
+        break;
+    }
+    case output_format::columnar:
+        for (size_t c = 0; c < streams.size(); c++)
+            streams[c].reserve(footers.size() * columns[c].size_bytes);
+        for (const auto &f : footers) {
+            append_bytes(streams[0], f.trigger_timestamp);
+            append_bytes(streams[1], f.record_number);
+            append_bytes(streams[2], f.frame_count);
+            append_bytes(streams[3], uint8_t(f.aux_in_state));
+            if constexpr (has_analog)
+                append_bytes(streams[4], f.analog_value);
+        }
+        break;
+    }
+}
+
+/// Per-input-file state
+struct input_file {
+    fs::path path;
+    size_t buffer_count;
+    size_t buffers_per_chunk;
+    size_t chunk_count;
+
+    /// Guards the members below
+    std::mutex mutex;
+    /// Signaled when `next_chunk_to_write` advances or `failed` is set
+    std::condition_variable chunk_written;
+    std::vector<std::ofstream> outputs;
+
+    /// Formatted output of chunks that completed before an earlier chunk
+    std::map<size_t, std::vector<std::string>> pending;
+    size_t next_chunk_to_write = 0;
+    bool failed = false;
+};
+
+struct chunk_task {
+    input_file *file;
+    size_t index;
+};
+
+std::vector<fs::path> output_paths(const options &opts,
+                                   const fs::path &input,
+                                   ats_footer_type footer_type) {
+    const auto stem = input.stem().string();
+    switch (opts.format) {
+    case output_format::binary:
+        return {opts.output_directory / (stem + ".footers.bin")};
+    case output_format::csv:
+        return {opts.output_directory / (stem + ".footers.csv")};
+    case output_format::columnar: {
+        std::vector<fs::path> paths;
+        for (size_t c = 0; c < column_count(footer_type); c++)
+            paths.push_back(opts.output_directory
+                            / (stem + "." + columns[c].name + ".bin"));
+        return paths;
+    }
+    }
+    return {};
+}
+
+/// Writes chunk `index` of `file`, and any chunk after it that was waiting
+void commit_chunk(input_file &file, size_t index,
+                  std::vector<std::string> streams) {
+    std::lock_guard<std::mutex> lock(file.mutex);
+    if (file.failed)
+        return;
+    file.pending.emplace(index, std::move(streams));
+    for (auto it = file.pending.find(file.next_chunk_to_write);
+         it != file.pending.end();
+         it = file.pending.find(file.next_chunk_to_write)) {
+        for (size_t s = 0; s < it->second.size(); s++)
+            file.outputs[s].write(it->second[s].data(),
+                                  static_cast<std::streamsize>(
+                                      it->second[s].size()));
+        file.pending.erase(it);
+        file.next_chunk_to_write++;
+    }
+    file.chunk_written.notify_all();
+}
+
+/// Statistics shared between worker threads
+struct totals {
+    std::atomic<uint64_t> footers{0};
+    std::atomic<uint64_t> bytes{0};
+};
+
+void process_chunk(const options &opts, const ats_footer_layout &layout,
+                   ats_footer_type footer_type, const chunk_task &task,
+                   std::vector<char> &data, totals &totals) {
+    input_file &file = *task.file;
+    const size_t first_buffer = task.index * file.buffers_per_chunk;
+    const size_t buffer_count = std::min(file.buffers_per_chunk,
+                                         file.buffer_count - first_buffer);
+    const size_t size_bytes = buffer_count * layout.buffer_stride_bytes;
+
+    data.resize(size_bytes);
+    std::ifstream stream(file.path, std::ios::binary);
+    stream.seekg(static_cast<std::streamoff>(first_buffer
+                                             * layout.buffer_stride_bytes));
+    if (!stream.read(data.data(), static_cast<std::streamsize>(size_bytes)))
+        throw std::runtime_error("Error: could not read " + file.path.string());
+
+    const size_t footer_count = buffer_count * layout.records_per_buffer;
+    const span<char> buffer(data.data(), data.size());
+    std::vector<std::string> streams(
+        opts.format == output_format::columnar ? column_count(footer_type)
+                                               : 1);
+    if (footer_type == ats_footer_type::type_0) {
+        std::vector<ats_footer_type_0> footers(footer_count);
+        ats_parse_footers(buffer, opts.configuration,
+                          span(footers.data(), footers.size()));
+        format_footers(span(footers.data(), footers.size()), opts.format,
+                       streams);
+    } else {
+        std::vector<ats_footer_type_1> footers(footer_count);
+        ats_parse_footers(buffer, opts.configuration,
+                          span(footers.data(), footers.size()));
+        format_footers(span(footers.data(), footers.size()), opts.format,
+                       streams);
+    }
+
+    commit_chunk(file, task.index, std::move(streams));
+    totals.footers += footer_count;
+    totals.bytes += size_bytes;
+}
+
+int run(const options &opts) {
+    const auto layout = ats_get_footer_layout(opts.configuration);
+    const auto footer_type = get_ats_footer_type(opts.configuration.board_type);
+
+    // Check all inputs before creating any output file
+    std::map<fs::path, fs::path> output_inputs;
+    for (const auto &path : opts.inputs) {
+        const auto size_bytes = fs::file_size(path);
+        if (size_bytes % layout.buffer_stride_bytes) {
+            std::ostringstream ostr;
+            ostr << "Error: size of " << path.string() << " (" << size_bytes
+                 << " bytes) is not a multiple of the DMA buffer size ("
+                 << layout.buffer_stride_bytes << " bytes)";
+            throw std::runtime_error(ostr.str());
+        }
+        if (!size_bytes)
+            throw std::runtime_error("Error: " + path.string() + " is empty");
+        for (const auto &output : output_paths(opts, path, footer_type)) {
+            const auto inserted
+                = output_inputs.emplace(output.lexically_normal(), path);
+            if (!inserted.second)
+                throw std::runtime_error(
+                    "Error: " + inserted.first->second.string() + " and "
+                    + path.string() + " would both be written to "
+                    + output.string());
+        }
+    }
+
+    fs::create_directories(opts.output_directory);
+
+    std::vector<std::unique_ptr<input_file>> files;
+    std::vector<chunk_task> tasks;
+    for (const auto &path : opts.inputs) {
+        auto file = std::make_unique<input_file>();
+        file->path = path;
+        file->buffer_count = fs::file_size(path) / layout.buffer_stride_bytes;
+        file->buffers_per_chunk = std::max<size_t>(
+            1, opts.chunk_bytes / layout.buffer_stride_bytes);
+        file->chunk_count
+            = (file->buffer_count + file->buffers_per_chunk - 1)
+              / file->buffers_per_chunk;
+        for (const auto &output : output_paths(opts, path, footer_type)) {
+            file->outputs.emplace_back(output, std::ios::binary);
+            if (!file->outputs.back())
+                throw std::runtime_error("Error: could not create "
+                                         + output.string());
+        }
+        if (opts.format == output_format::csv) {
+            file->outputs[0] << "trigger_timestamp,record_number,frame_count,"
+                                "aux_in_state"
+                             << (footer_type == ats_footer_type::type_1
+                                     ? ",analog_value\n"
+                                     : "\n");
+        }
+        for (size_t c = 0; c < file->chunk_count; c++)
+            tasks.push_back({file.get(), c});
+        files.push_back(std::move(file));
+    }
+
+    totals totals;
+    std::atomic<size_t> next_task{0};
+    std::mutex error_mutex;
+    const auto start = std::chrono::steady_clock::now();
+    const size_t thread_count = std::min(opts.thread_count, tasks.size());
+
+    // Tasks are handed out in order, so the chunk that `next_chunk_to_write`
+    // waits for is always being processed, and waiting for it to be written
+    // bounds the formatted output held in `pending`.
+    const size_t max_chunks_in_flight = 2 * std::max<size_t>(thread_count, 1);
+    auto worker = [&]() {
+        std::vector<char> data;
+        for (size_t t = next_task++; t < tasks.size(); t = next_task++) {
+            const auto &task = tasks[t];
+            {
+                std::unique_lock<std::mutex> lock(task.file->mutex);
+                task.file->chunk_written.wait(lock, [&]() {
+                    return task.file->failed
+                           || task.index < task.file->next_chunk_to_write
+                                               + max_chunks_in_flight;
+                });
+                if (task.file->failed)
+                    continue;
+            }
+            try {
+                process_chunk(opts, layout, footer_type, task, data, totals);
+            } catch (const std::exception &e) {
+                std::lock_guard<std::mutex> error_lock(error_mutex);
+                std::lock_guard<std::mutex> lock(task.file->mutex);
+                if (!task.file->failed)
+                    std::cerr << task.file->path.string() << ": " << e.what()
+                              << "\n";
+                task.file->failed = true;
+                task.file->chunk_written.notify_all();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; i++)
+        threads.emplace_back(worker);
+    worker();
+    for (auto &thread : threads)
+        thread.join();
+
+    int status = 0;
+    for (auto &file : files) {
+        for (auto &output : file->outputs) {
+            output.close();
+            if (!output)
+                file->failed = true;
+        }
+        if (file->failed)
+            status = 1;
+    }
+
+    const double seconds = std::max(
+        1e-9, std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                            - start)
+                  .count());
+    const double megabytes = totals.bytes / 1e6;
+    std::cerr << "Processed " << files.size() << " file(s), "
+              << totals.footers << " footers, " << megabytes << " MB in "
+              << seconds << " s (" << megabytes / seconds << " MB/s, "
+              << totals.footers / seconds << " footers/s) using "
+              << std::max<size_t>(thread_count, 1) << " thread(s)\n";
+    return status;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    try {
+        return run(parse_options(argc, argv));
+    } catch (const std::exception &e) {
+        std::cerr << "atsfooters-dump: " << e.what() << "\n";
+        return 2;
+    }
+}
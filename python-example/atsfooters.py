@@ -1,7 +1,9 @@
 import os
 from collections import namedtuple
 from ctypes import (
+    byref,
     c_bool,
+    c_char,
     c_char_p,
     c_int16,
     c_size_t,
@@ -87,6 +89,10 @@ class FooterType(Enumeration):
     type_0 = 0
     type_1 = 1
 
+class ArrowFormat(Enumeration):
+    stream = 0
+    file = 1
+
 class FooterType0(PrintableStructure):
     _fields_ = [
         ("trigger_timestamp", c_uint64 ),
@@ -178,6 +184,10 @@ class ATSFooters():
         os.add_dll_directory(os.path.dirname(__file__))
         self.lib = CDLL("atsfooters.dll")
 
+        self.lib.c_get_ats_footer_type.restype = c_uint32
+        self.lib.c_get_ats_footer_type.argtypes = [BoardType, POINTER(FooterType), c_char_p, c_size_t]
+        self.lib.c_get_ats_footer_type.errcheck = _rccheck
+
         self.lib.c_ats_parse_footers_type_0.restype = c_uint32
         self.lib.c_ats_parse_footers_type_0.argtypes = [c_void_p, c_size_t, FooterConfiguration, POINTER(FooterType0), c_size_t, c_char_p, c_size_t]
         self.lib.c_ats_parse_footers_type_0.errcheck = _rccheck
@@ -186,6 +196,20 @@ class ATSFooters():
         self.lib.c_ats_parse_footers_type_1.argtypes = [c_void_p, c_size_t, FooterConfiguration, POINTER(FooterType1), c_size_t, c_char_p, c_size_t]
         self.lib.c_ats_parse_footers_type_1.errcheck = _rccheck
 
+        self.lib.c_ats_arrow_ipc_size.restype = c_size_t
+        self.lib.c_ats_arrow_ipc_size.argtypes = [FooterType, c_size_t, ArrowFormat]
+
+        self.lib.c_ats_export_arrow_ipc.restype = c_uint32
+        self.lib.c_ats_export_arrow_ipc.argtypes = [c_void_p, c_size_t, FooterConfiguration, c_size_t, ArrowFormat, c_void_p, c_size_t, c_char_p, c_size_t]
+        self.lib.c_ats_export_arrow_ipc.errcheck = _rccheck
+
+    def footer_type(self, board_type):
+        footer_type = FooterType(0)
+        errstrsize = 256
+        errstr = create_string_buffer(errstrsize)
+        self.lib.c_get_ats_footer_type(board_type, byref(footer_type), errstr, errstrsize)
+        return FooterType(footer_type.value)
+
     def parse_type_0(self, np_data, footer_configuration, footer_count):
         footers = (FooterType0 * footer_count)()
         errstrsize = 256
@@ -201,3 +225,14 @@ class ATSFooters():
         self.lib.c_ats_parse_footers_type_1(
             np_data.ctypes.data, np_data.size * np_data.itemsize, footer_configuration, footers, footer_count, errstr, errstrsize)
         return footers
+
+    def export_arrow(self, np_data, footer_configuration, footer_count, arrow_format=ArrowFormat.stream):
+        """Returns footers as Arrow IPC data, e.g. for `pyarrow.ipc.open_stream()`"""
+        footer_type = self.footer_type(footer_configuration.board_type)
+        size = self.lib.c_ats_arrow_ipc_size(footer_type, footer_count, arrow_format)
+        output = (c_char * size)()
+        errstrsize = 256
+        errstr = create_string_buffer(errstrsize)
+        self.lib.c_ats_export_arrow_ipc(
+            np_data.ctypes.data, np_data.size * np_data.itemsize, footer_configuration, footer_count, arrow_format, output, size, errstr, errstrsize)
+        return memoryview(output).cast("B")